@@ -0,0 +1,468 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+// A long-running process which keeps a warm index of every CMake file under a
+// directory, reparsing files as inotify reports changes to them, and which answers
+// queries over a Unix socket.
+//
+// Usage: shipwright.daemon <project-root> <socket-path>
+//
+// Files are indexed untrusted: each is limited in size and complexity, and any
+// file exceeding a limit is reported as an error rather than indexed.
+//
+// Each request is a single line. Each response is zero or more lines followed by an
+// empty line. Requests:
+//
+//     files               Every indexed file, followed by `ok` or `error`
+//     errors              Every indexed file which is not valid UTF-8 or failed to parse
+//     commands <name>     `path:line:column` of every invocation of command <name>
+//     definitions <name>  `path:line:column how` of everywhere variable <name> is set,
+//                         where `how` is set, unset, option, list or math
+//     references <name>   `path:line:column` of everywhere variable <name> is read
+//     rescan              Drops the index and rebuilds it from scratch
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <shipwright/project/index.hpp>
+#include <shipwright/strings.hpp>
+
+namespace {
+    constexpr auto watch_mask = IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM
+        | IN_MOVED_TO | IN_DELETE_SELF | IN_ONLYDIR;
+
+    shipwright::parse_options untrusted_options()
+    {
+        shipwright::limits limits;
+        limits.max_bytes = 16 * 1024 * 1024;
+        limits.max_token_bytes = 1024 * 1024;
+        limits.max_nesting_depth = 256;
+        limits.max_ast_bytes = 256 * 1024 * 1024;
+        return shipwright::parse_options{limits};
+    }
+
+    // Whether `entry`, read from `dir`, is a directory. Not every file system fills in
+    // `d_type`, so it is checked with `fstatat` when that is unknown. Symbolic links are
+    // never followed, as with `d_type`.
+    bool is_directory(DIR* dir, dirent const& entry)
+    {
+        if (entry.d_type != DT_UNKNOWN) return entry.d_type == DT_DIR;
+
+        struct stat status;
+        return fstatat(dirfd(dir), entry.d_name, &status, AT_SYMLINK_NOFOLLOW) == 0
+            && S_ISDIR(status.st_mode);
+    }
+
+    class server
+    {
+    public:
+        server(std::string root, int inotify_fd)
+            : root_{std::move(root)}
+            , inotify_fd_{inotify_fd}
+            , index_{::untrusted_options()}
+        {}
+
+        void rescan()
+        {
+            for (auto const& [wd, path] : watches_) {
+                (void)path;
+                inotify_rm_watch(inotify_fd_, wd);
+            }
+            watches_.clear();
+            index_.clear();
+
+            add_directory(root_);
+        }
+
+        void handle_inotify()
+        {
+            alignas(inotify_event) char buffer[64 * 1024];
+
+            for (;;) {
+                auto const length = read(inotify_fd_, buffer, sizeof(buffer));
+                if (length <= 0) return;
+
+                for (auto pos = buffer; pos < buffer + length;) {
+                    auto const& event = *reinterpret_cast<inotify_event const*>(pos);
+                    pos += sizeof(inotify_event) + event.len;
+
+                    handle_event(event);
+                }
+            }
+        }
+
+        std::string respond(std::string_view request) const
+        {
+            auto const split = request.find(' ');
+            auto const verb = request.substr(0, split);
+            auto const arg = split == std::string_view::npos ? std::string_view{}
+                                                              : request.substr(split + 1);
+
+            std::ostringstream out;
+
+            if (verb == "files") {
+                index_.for_each([&](std::string_view path, auto const& entry) {
+                    out << path << ' ' << (entry.file ? "ok" : "error") << '\n';
+                });
+            } else if (verb == "errors") {
+                index_.for_each([&](std::string_view path, auto const& entry) {
+                    if (entry.invalid_utf8_offset) {
+                        out << path << ": invalid UTF-8 at offset " << *entry.invalid_utf8_offset
+                            << '\n';
+                    }
+                    if (entry.error) {
+                        auto const location = entry.locate(entry.error->offset);
+                        out << path << ':' << location.line << ':' << location.column << ": "
+                            << entry.error->message << '\n';
+                    }
+                });
+            } else if (verb == "commands") {
+                index_.for_each([&](std::string_view path, auto const& entry) {
+                    if (!entry.file) return;
+
+                    for (auto const& element : entry.file->elements) {
+                        auto const* command
+                            = std::get_if<shipwright::ast::command_invocation>(&element.value);
+                        if (!command || !shipwright::iequals(command->command_id.value, arg)) {
+                            continue;
+                        }
+
+                        auto const location = entry.locate(static_cast<std::size_t>(
+                            command->command_id.value.data() - entry.text.data()));
+                        out << path << ':' << location.line << ':' << location.column << '\n';
+                    }
+                });
+            } else if (verb == "definitions" || verb == "references") {
+                bool const definitions = verb == "definitions";
+
+                for (auto const& site : index_.variables().find(std::string{arg})) {
+                    if (shipwright::is_definition(site.use) != definitions) continue;
+
+                    auto const* entry = index_.find(std::string{site.path});
+                    auto const location = entry->locate(site.offset);
+
+                    out << site.path << ':' << location.line << ':' << location.column;
+                    if (definitions) out << ' ' << shipwright::variable_use_name(site.use);
+                    out << '\n';
+                }
+            } else {
+                out << "unknown request: " << verb << '\n';
+            }
+
+            out << '\n';
+            return std::move(out).str();
+        }
+
+    private:
+        void add_directory(std::string const& path)
+        {
+            auto const wd = inotify_add_watch(inotify_fd_, path.c_str(), watch_mask);
+            if (wd < 0) {
+                std::cerr << "cannot watch " << path << ": " << std::strerror(errno) << '\n';
+                return;
+            }
+            watches_.insert_or_assign(wd, path);
+
+            // Entries created between adding the watch and reading the directory may be
+            // seen twice, which is harmless. Adding the watch first means none are missed.
+            auto* dir = opendir(path.c_str());
+            if (!dir) return;
+
+            while (auto const* dirent = readdir(dir)) {
+                std::string_view const name = dirent->d_name;
+                if (name.empty() || name.front() == '.') continue;
+
+                auto child = path + '/' + std::string{name};
+
+                if (::is_directory(dir, *dirent)) {
+                    add_directory(child);
+                } else if (shipwright::is_cmake_file(name)) {
+                    index_.update(child);
+                }
+            }
+
+            closedir(dir);
+        }
+
+        void handle_event(inotify_event const& event)
+        {
+            if (event.mask & IN_Q_OVERFLOW) {
+                std::cerr << "inotify queue overflowed; rescanning\n";
+                rescan();
+                return;
+            }
+
+            auto const dir = watches_.find(event.wd);
+            if (dir == watches_.end()) return;
+
+            if (event.mask & (IN_DELETE_SELF | IN_IGNORED)) {
+                watches_.erase(dir);
+                return;
+            }
+
+            if (event.len == 0) return;
+            std::string_view const name = event.name;
+            if (name.front() == '.') return;
+
+            auto path = dir->second + '/' + std::string{name};
+
+            if (event.mask & IN_ISDIR) {
+                if (event.mask & (IN_CREATE | IN_MOVED_TO)) {
+                    add_directory(path);
+                } else if (event.mask & IN_MOVED_FROM) {
+                    remove_directory(path);
+                }
+                return;
+            }
+
+            if (!shipwright::is_cmake_file(name)) return;
+
+            if (event.mask & (IN_DELETE | IN_MOVED_FROM)) {
+                index_.remove(path);
+            } else {
+                index_.update(path);
+            }
+        }
+
+        void remove_directory(std::string const& path)
+        {
+            auto const prefix = path + '/';
+
+            std::vector<std::string> removed;
+            index_.for_each([&](std::string_view file, auto const&) {
+                if (file.substr(0, prefix.size()) == prefix) removed.emplace_back(file);
+            });
+
+            for (auto const& file : removed) {
+                index_.remove(file);
+            }
+
+            // The watches follow the directory to wherever it moved, which we aren't indexing
+            for (auto it = watches_.begin(); it != watches_.end();) {
+                if (it->second == path || it->second.compare(0, prefix.size(), prefix) == 0) {
+                    inotify_rm_watch(inotify_fd_, it->first);
+                    it = watches_.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+
+        std::string root_;
+        int inotify_fd_;
+        std::unordered_map<int, std::string> watches_;
+        shipwright::project_index index_;
+    };
+
+    int listen_on(std::string const& socket_path)
+    {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (socket_path.size() >= sizeof(address.sun_path)) {
+            std::cerr << "socket path too long: " << socket_path << '\n';
+            return -1;
+        }
+        std::memcpy(address.sun_path, socket_path.c_str(), socket_path.size() + 1);
+
+        auto const fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) return -1;
+
+        // Replace a socket left behind by an earlier run, but never delete anything else
+        struct stat existing;
+        if (lstat(socket_path.c_str(), &existing) == 0) {
+            if (!S_ISSOCK(existing.st_mode)) {
+                close(fd);
+                errno = ENOTSOCK;
+                return -1;
+            }
+            unlink(socket_path.c_str());
+        }
+
+        if (bind(fd, reinterpret_cast<sockaddr const*>(&address), sizeof(address)) != 0
+            || listen(fd, 16) != 0) {
+            close(fd);
+            return -1;
+        }
+
+        return fd;
+    }
+
+    // Longer requests are never valid, so a client sending one is disconnected
+    constexpr std::size_t max_request_bytes = 4 * 1024;
+    // Once this much output is waiting, no more requests are answered until it's sent
+    constexpr std::size_t max_pending_output = 1024 * 1024;
+
+    struct client
+    {
+        // Received requests not yet answered, the last of which may be incomplete
+        std::string input;
+        // Responses not yet accepted by the socket
+        std::string output;
+        // The client has finished sending; close once its responses are flushed
+        bool finished = false;
+    };
+
+    // Sends as much of the client's output as the socket will take without blocking.
+    // Returns false if the client has gone away.
+    bool flush(int fd, client& client)
+    {
+        std::string_view data = client.output;
+        while (!data.empty()) {
+            // Clients may hang up at any time; that mustn't kill the daemon with SIGPIPE
+            auto const written = send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                return false;
+            }
+            data.remove_prefix(static_cast<std::size_t>(written));
+        }
+        client.output.erase(0, client.output.size() - data.size());
+        return true;
+    }
+
+    // Answers the client's complete requests, stopping early if enough output builds up.
+    // Returns false if the client has sent an overlong request.
+    bool answer(client& client, ::server& state)
+    {
+        std::size_t consumed = 0;
+        for (auto newline = client.input.find('\n'); newline != std::string::npos;
+             newline = client.input.find('\n', consumed)) {
+            if (client.output.size() >= max_pending_output) break;
+
+            std::string_view const request
+                = std::string_view{client.input}.substr(consumed, newline - consumed);
+            consumed = newline + 1;
+
+            if (request.size() > max_request_bytes) return false;
+
+            if (request == "rescan") {
+                state.rescan();
+                client.output += '\n';
+            } else {
+                client.output += state.respond(request);
+            }
+        }
+        client.input.erase(0, consumed);
+
+        return client.input.find('\n') != std::string::npos
+            || client.input.size() <= max_request_bytes;
+    }
+
+    // Reads whatever has arrived. Returns false if the client has gone away.
+    bool receive(int fd, client& client)
+    {
+        char buffer[4096];
+        auto const length = read(fd, buffer, sizeof(buffer));
+        if (length < 0) return errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK;
+        if (length == 0) {
+            client.finished = true;
+            return true;
+        }
+        client.input.append(buffer, static_cast<std::size_t>(length));
+        return true;
+    }
+
+    // Answers requests and sends responses until the socket is full or nothing is left to
+    // answer. Returns false if the client has gone away or misbehaved.
+    bool serve(int fd, client& client, ::server& state)
+    {
+        for (;;) {
+            if (!::answer(client, state) || !::flush(fd, client)) return false;
+            if (!client.output.empty() || client.input.find('\n') == std::string::npos) {
+                return true;
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <project-root> <socket-path>\n";
+        return 2;
+    }
+
+    auto const inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_fd < 0) {
+        std::cerr << "inotify_init1: " << std::strerror(errno) << '\n';
+        return 1;
+    }
+
+    std::string const socket_path = argv[2];
+    auto const listen_fd = listen_on(socket_path);
+    if (listen_fd < 0) {
+        std::cerr << "cannot listen on " << socket_path << ": " << std::strerror(errno) << '\n';
+        return 1;
+    }
+
+    ::server state{argv[1], inotify_fd};
+    state.rescan();
+
+    // Sockets are non-blocking, so a client which stops reading its responses only holds
+    // up itself; its responses wait in its output buffer until the socket takes them.
+    std::unordered_map<int, ::client> clients;
+
+    for (;;) {
+        std::vector<pollfd> fds{
+            {inotify_fd, POLLIN, 0},
+            {listen_fd, POLLIN, 0},
+        };
+        for (auto const& [fd, client] : clients) {
+            // Don't read more requests from a client until it has taken its responses, so
+            // that neither its input nor its output can grow without bound
+            fds.push_back({fd, static_cast<short>(client.output.empty() ? POLLIN : POLLOUT), 0});
+        }
+
+        if (poll(fds.data(), fds.size(), -1) < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "poll: " << std::strerror(errno) << '\n';
+            return 1;
+        }
+
+        // Apply pending changes before answering anything, so that answers are never stale
+        if (fds[0].revents & POLLIN) state.handle_inotify();
+
+        if (fds[1].revents & POLLIN) {
+            auto const fd = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd >= 0) clients.emplace(fd, ::client{});
+        }
+
+        for (auto it = fds.begin() + 2; it != fds.end(); ++it) {
+            auto& client = clients[it->fd];
+
+            bool open = true;
+            if (it->revents & POLLOUT) {
+                // Requests held back while output was waiting can be answered now
+                open = ::flush(it->fd, client)
+                    && (!client.output.empty() || ::serve(it->fd, client, state));
+            } else if (it->revents & (POLLIN | POLLHUP | POLLERR)) {
+                open = ::receive(it->fd, client) && ::serve(it->fd, client, state);
+            }
+
+            if (!open || (client.finished && client.output.empty())) {
+                close(it->fd);
+                clients.erase(it->fd);
+            }
+        }
+    }
+}
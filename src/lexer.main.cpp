@@ -4,23 +4,134 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 
+// Lexes stdin, printing each token to stdout.
+//
+// Usage: shipwright.lexer [--format=text|jsonl|binary] [--validate-utf8] [--parallel]
+//        shipwright.lexer --ast [--format=jsonl] [--validate-utf8]
+//
+// Offsets are in bytes from the start of stdin. With --validate-utf8, nothing is
+// printed if the input is not valid UTF-8, and a UTF-8 byte order mark is skipped,
+// so offsets are then from the byte after it. With --parallel, large inputs are
+// lexed using every hardware thread. With --ast, the input is parsed, and its AST
+// is printed as JSON lines; nothing is printed if it fails to parse.
+//
+// Inputs larger than 4 GiB, counting any byte order mark, are rejected, as no
+// output format can describe their offsets.
+
+#include <cstdio>
 #include <iostream>
-#include <sstream>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
 
+#include <shipwright/input/input.hpp>
 #include <shipwright/lexer.hpp>
+#include <shipwright/lexer/parallel.hpp>
+#include <shipwright/output/ast.hpp>
+#include <shipwright/output/tokens.hpp>
+#include <shipwright/parser.hpp>
 
-int main()
+int main(int argc, char** argv)
 {
-    auto const input = [] {
-        std::ostringstream out;
-        out << std::cin.rdbuf();
-        return out.str();
-    }();
+    using namespace std::literals;
+    namespace output = shipwright::output;
+
+    std::optional<output::format> format;
+    shipwright::input::load_options load_options{false};
+    bool parallel = false;
+    bool ast = false;
+    bool usage_error = false;
+
+    for (int i = 1; i < argc && !usage_error; ++i) {
+        std::string_view const arg = argv[i];
+        auto const prefix = "--format="sv;
+
+        if (arg == "--validate-utf8") {
+            load_options.validate_utf8 = true;
+        } else if (arg == "--parallel") {
+            parallel = true;
+        } else if (arg == "--ast") {
+            ast = true;
+        } else if (arg.substr(0, prefix.size()) == prefix) {
+            format = output::parse_format(arg.substr(prefix.size()));
+            usage_error = !format;
+        } else {
+            usage_error = true;
+        }
+    }
+
+    if (ast) {
+        // ASTs are only written as JSON lines
+        if (!format) format = output::format::json_lines;
+        if (parallel || format != output::format::json_lines) usage_error = true;
+    }
+    if (usage_error) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [--format=text|jsonl|binary] [--validate-utf8] [--parallel]\n"
+                  << "       " << argv[0] << " --ast [--format=jsonl] [--validate-utf8]\n";
+        return 2;
+    }
+    if (!format) format = output::format::text;
+
+    // Only skip a byte order mark when asked to look at the encoding at all
+    load_options.strip_utf8_bom = load_options.validate_utf8;
+    load_options.max_bytes = output::max_input_bytes;
 
-    shipwright::lexer lex{input};
+#ifdef _WIN32
+    _setmode(_fileno(stdin), _O_BINARY);
+    if (format == output::format::binary) _setmode(_fileno(stdout), _O_BINARY);
+#endif
+
+    auto const loaded = shipwright::input::load(stdin, load_options);
+    if (!loaded) {
+        std::cerr << "error reading input\n";
+        return 1;
+    }
+    if (loaded->too_large) {
+        std::cerr << "input is larger than 4 GiB\n";
+        return 1;
+    }
+    if (loaded->invalid_utf8_offset) {
+        std::cerr << "invalid UTF-8 at offset " << *loaded->invalid_utf8_offset << '\n';
+        return 1;
+    }
+
+    std::string_view const input = loaded->text;
+
+    output::buffered_writer out{stdout};
+
+    if (ast) {
+        auto const result = shipwright::parse(input, shipwright::parse_options{});
+        if (auto const* error = std::get_if<shipwright::parse_error>(&result)) {
+            std::cerr << "parse error at offset " << error->offset << ": " << error->message
+                      << '\n';
+            return 1;
+        }
+        output::write_ast_json_lines(out, std::get<shipwright::ast::file>(result), input);
+    } else {
+        output::write_header(out, *format);
+
+        if (parallel) {
+            for (auto const& token : shipwright::lex_parallel(input)) {
+                output::write_token(out, *format, token, input);
+            }
+        } else {
+            shipwright::lexer lex{input};
+            for (auto const& token : lex) {
+                output::write_token(out, *format, token, input);
+            }
+        }
+    }
 
-    for (auto const& token : lex) {
-        std::cout << shipwright::debug_print(token) << '\n';
+    if (!out.flush()) {
+        std::cerr << "error writing output\n";
+        return 1;
     }
 }
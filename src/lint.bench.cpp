@@ -0,0 +1,86 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+// Compares running N lint rules in one fused traversal against running each
+// rule in its own traversal, as N grows.
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <shipwright/lint/lint.hpp>
+#include <shipwright/parser.hpp>
+
+#include "./timing.bench.hpp"
+
+namespace ast = shipwright::ast;
+namespace bench = shipwright::bench;
+namespace lint = shipwright::lint;
+
+namespace {
+    template <int I>
+    struct argument_rule
+    {
+        static constexpr std::string_view name = "argument-rule";
+
+        void visit(ast::unquoted_argument const& argument, lint::context& ctx) const
+        {
+            // Never true, but the compiler can't know that
+            if (argument.value.size() == 1000 + I) ctx.report(argument.value, "too long");
+        }
+    };
+
+    std::string generate_input(int lines)
+    {
+        std::ostringstream out;
+        for (int i = 0; i < lines; ++i) {
+            out << "set(var_" << i << " value_" << i << " CACHE STRING \"doc\")\n"
+                << "target_link_libraries(target_" << i << " PUBLIC a b c PRIVATE d e f)\n"
+                << "if(${var_" << i << "} AND (x OR y)) # comment\n"
+                << "message(STATUS \"value: ${var_" << i << "}\")\n";
+        }
+        return out.str();
+    }
+
+    template <int... I>
+    void measure(lint::input const& in, std::integer_sequence<int, I...>)
+    {
+        lint::engine const fused{argument_rule<I>{}...};
+        auto const fused_ms = bench::best_of_ms([&] { (void)fused.run(in); });
+
+        auto const separate_ms = bench::best_of_ms([&] {
+            ((void)lint::engine{argument_rule<I>{}}.run(in), ...);
+        });
+
+        std::cout << std::setw(6) << sizeof...(I) << std::setw(12) << std::fixed
+                  << std::setprecision(3) << fused_ms << std::setw(12) << separate_ms << '\n';
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int const lines = bench::input_lines(argc, argv);
+
+    auto const text = generate_input(lines);
+    auto const file = shipwright::parse(text);
+    if (!file) {
+        std::cerr << "failed to parse generated input\n";
+        return 1;
+    }
+
+    lint::input const in{"generated", text, &*file};
+
+    std::cout << " rules    fused ms separate ms\n";
+    measure(in, std::make_integer_sequence<int, 1>{});
+    measure(in, std::make_integer_sequence<int, 2>{});
+    measure(in, std::make_integer_sequence<int, 4>{});
+    measure(in, std::make_integer_sequence<int, 8>{});
+    measure(in, std::make_integer_sequence<int, 16>{});
+    measure(in, std::make_integer_sequence<int, 32>{});
+}
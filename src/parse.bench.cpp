@@ -0,0 +1,80 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+// Compares lexing and parsing with trivia kept against skipping it, on input
+// with a typical amount of comments and indentation.
+
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <variant>
+
+#include <shipwright/lexer.hpp>
+#include <shipwright/parser.hpp>
+
+#include "./timing.bench.hpp"
+
+namespace bench = shipwright::bench;
+
+namespace {
+    std::string generate_input(int lines)
+    {
+        std::ostringstream out;
+        for (int i = 0; i < lines; ++i) {
+            out << "# Target " << i << "\n"
+                << "add_library(target_" << i << "\n"
+                << "    a.cpp # the first source\n"
+                << "    b.cpp\n"
+                << "    #[[c.cpp]]\n"
+                << ")\n"
+                << "\n"
+                << "target_link_libraries(target_" << i << " PUBLIC a b c) # deps\n";
+        }
+        return out.str();
+    }
+
+    std::size_t lex(std::string_view text, shipwright::trivia mode)
+    {
+        shipwright::lexer lex{text, {}, mode};
+        return static_cast<std::size_t>(std::distance(lex.begin(), lex.end()));
+    }
+
+    bool parse(std::string_view text, shipwright::trivia mode)
+    {
+        shipwright::parse_options options;
+        options.trivia = mode;
+        return std::holds_alternative<shipwright::ast::file>(shipwright::parse(text, options));
+    }
+}
+
+int main(int argc, char** argv)
+{
+    using shipwright::trivia;
+
+    int const lines = bench::input_lines(argc, argv);
+
+    auto const text = generate_input(lines);
+    if (!::parse(text, trivia::keep) || !::parse(text, trivia::skip)) {
+        std::cerr << "failed to parse generated input\n";
+        return 1;
+    }
+
+    std::cout << "         keep ms     skip ms\n" << std::fixed << std::setprecision(3);
+
+    std::cout << "lex  " << std::setw(12)
+              << bench::best_of_ms([&] { (void)::lex(text, trivia::keep); })
+              << std::setw(12)
+              << bench::best_of_ms([&] { (void)::lex(text, trivia::skip); }) << '\n';
+
+    std::cout << "parse" << std::setw(12)
+              << bench::best_of_ms([&] { (void)::parse(text, trivia::keep); })
+              << std::setw(12)
+              << bench::best_of_ms([&] { (void)::parse(text, trivia::skip); }) << '\n';
+}
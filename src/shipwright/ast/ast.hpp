@@ -63,6 +63,13 @@ namespace shipwright::ast {
             value;
     };
 
+    // Comments may appear among a command's arguments, but are not arguments to CMake
+    inline bool is_comment(argument const& argument)
+    {
+        return std::holds_alternative<line_comment>(argument.value)
+            || std::holds_alternative<bracket_comment>(argument.value);
+    }
+
     struct command_invocation
     {
         identifier command_id;
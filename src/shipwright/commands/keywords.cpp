@@ -0,0 +1,193 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "./keywords.hpp"
+
+#include <cassert>
+#include <utility>
+#include <variant>
+
+#include <frozen/string.h>
+#include <frozen/unordered_map.h>
+
+#include <shipwright/strings.hpp>
+
+using shipwright::commands::builtin_command;
+using shipwright::commands::keyword;
+using shipwright::commands::keyword_kind;
+namespace commands = shipwright::commands;
+
+namespace {
+    // Few enough, and mostly of different lengths, that comparing each name in turn is cheap
+    constexpr std::pair<std::string_view, builtin_command> builtin_commands[] = {
+        {"add_custom_command", builtin_command::add_custom_command},
+        {"add_custom_target", builtin_command::add_custom_target},
+        {"add_executable", builtin_command::add_executable},
+        {"add_library", builtin_command::add_library},
+        {"add_test", builtin_command::add_test},
+        {"cmake_minimum_required", builtin_command::cmake_minimum_required},
+        {"find_package", builtin_command::find_package},
+        {"install", builtin_command::install},
+        {"project", builtin_command::project},
+        {"set", builtin_command::set},
+        {"target_compile_definitions", builtin_command::target_compile_definitions},
+        {"target_compile_options", builtin_command::target_compile_options},
+        {"target_include_directories", builtin_command::target_include_directories},
+        {"target_link_libraries", builtin_command::target_link_libraries},
+        {"target_sources", builtin_command::target_sources},
+    };
+
+    // Hashes the keywords of one command's schema by name
+    template <std::size_t N, std::size_t... I>
+    constexpr auto make_lookup(keyword const (&keywords)[N], std::index_sequence<I...>)
+    {
+        return frozen::unordered_map<frozen::string, keyword_kind, N>{
+            std::pair<frozen::string, keyword_kind>{
+                frozen::string{keywords[I].name.data(), keywords[I].name.size()},
+                keywords[I].kind,
+            }...,
+        };
+    }
+
+    template <std::size_t N>
+    constexpr auto make_lookup(keyword const (&keywords)[N])
+    {
+        return ::make_lookup(keywords, std::make_index_sequence<N>{});
+    }
+
+    constexpr auto add_custom_command_lookup = ::make_lookup(commands::add_custom_command_keywords);
+    constexpr auto add_custom_target_lookup = ::make_lookup(commands::add_custom_target_keywords);
+    constexpr auto add_executable_lookup = ::make_lookup(commands::add_executable_keywords);
+    constexpr auto add_library_lookup = ::make_lookup(commands::add_library_keywords);
+    constexpr auto add_test_lookup = ::make_lookup(commands::add_test_keywords);
+    constexpr auto cmake_minimum_required_lookup
+        = ::make_lookup(commands::cmake_minimum_required_keywords);
+    constexpr auto find_package_lookup = ::make_lookup(commands::find_package_keywords);
+    constexpr auto install_lookup = ::make_lookup(commands::install_keywords);
+    constexpr auto project_lookup = ::make_lookup(commands::project_keywords);
+    constexpr auto set_lookup = ::make_lookup(commands::set_keywords);
+    constexpr auto target_compile_definitions_lookup
+        = ::make_lookup(commands::target_compile_definitions_keywords);
+    constexpr auto target_compile_options_lookup
+        = ::make_lookup(commands::target_compile_options_keywords);
+    constexpr auto target_include_directories_lookup
+        = ::make_lookup(commands::target_include_directories_keywords);
+    constexpr auto target_link_libraries_lookup
+        = ::make_lookup(commands::target_link_libraries_keywords);
+    constexpr auto target_sources_lookup = ::make_lookup(commands::target_sources_keywords);
+
+    template <typename Map>
+    std::optional<keyword_kind> find(Map const& keywords, std::string_view argument)
+    {
+        auto const lookup = keywords.find(frozen::string{argument.data(), argument.size()});
+        if (lookup == keywords.end()) return std::nullopt;
+
+        return lookup->second;
+    }
+}
+
+namespace shipwright::commands {
+    std::optional<builtin_command> find_builtin_command(std::string_view name)
+    {
+        for (auto const& [builtin_name, command] : builtin_commands) {
+            if (shipwright::iequals(name, builtin_name)) return command;
+        }
+        return std::nullopt;
+    }
+
+    std::optional<keyword_kind> find_keyword(builtin_command command, std::string_view argument)
+    {
+        switch (command) {
+        case builtin_command::add_custom_command:
+            return ::find(add_custom_command_lookup, argument);
+        case builtin_command::add_custom_target: return ::find(add_custom_target_lookup, argument);
+        case builtin_command::add_executable: return ::find(add_executable_lookup, argument);
+        case builtin_command::add_library: return ::find(add_library_lookup, argument);
+        case builtin_command::add_test: return ::find(add_test_lookup, argument);
+        case builtin_command::cmake_minimum_required:
+            return ::find(cmake_minimum_required_lookup, argument);
+        case builtin_command::find_package: return ::find(find_package_lookup, argument);
+        case builtin_command::install: return ::find(install_lookup, argument);
+        case builtin_command::project: return ::find(project_lookup, argument);
+        case builtin_command::set: return ::find(set_lookup, argument);
+        case builtin_command::target_compile_definitions:
+            return ::find(target_compile_definitions_lookup, argument);
+        case builtin_command::target_compile_options:
+            return ::find(target_compile_options_lookup, argument);
+        case builtin_command::target_include_directories:
+            return ::find(target_include_directories_lookup, argument);
+        case builtin_command::target_link_libraries:
+            return ::find(target_link_libraries_lookup, argument);
+        case builtin_command::target_sources: return ::find(target_sources_lookup, argument);
+        }
+
+        assert(false && "Unhandled builtin_command");
+        return std::nullopt;
+    }
+
+    std::optional<keyword_kind> find_keyword(
+        builtin_command command, ast::argument const& argument)
+    {
+        auto const* unquoted = std::get_if<ast::unquoted_argument>(&argument.value);
+        if (unquoted == nullptr) return std::nullopt;
+
+        return find_keyword(command, unquoted->value);
+    }
+
+    bool is_keyword(builtin_command command, std::string_view argument)
+    {
+        return find_keyword(command, argument).has_value();
+    }
+
+    bool is_keyword(builtin_command command, ast::argument const& argument)
+    {
+        return find_keyword(command, argument).has_value();
+    }
+
+    keyword_sections::iterator::iterator(
+        builtin_command command, ast::argument const* position, ast::argument const* last)
+        : command_{command}
+        , last_{last}
+    {
+        // Leading comments don't make a section of their own
+        while (position != last_ && ast::is_comment(*position)) {
+            ++position;
+        }
+        load(position, position != last_ ? find_keyword(command_, *position) : std::nullopt);
+    }
+
+    void keyword_sections::iterator::load(
+        ast::argument const* position, std::optional<keyword_kind> kind)
+    {
+        position_ = position;
+        next_kind_ = std::nullopt;
+        if (position == last_) {
+            section_ = keyword_section{{}, last_, last_, 0};
+            return;
+        }
+
+        section_.keyword = {};
+        section_.first = position;
+        // Positional arguments, like multi-value keywords, run up to the next keyword
+        auto max_count = static_cast<std::size_t>(-1);
+        if (kind) {
+            section_.keyword = std::get<ast::unquoted_argument>(position->value).value;
+            ++section_.first;
+
+            if (*kind == keyword_kind::option) max_count = 0;
+            if (*kind == keyword_kind::one_value) max_count = 1;
+        }
+
+        section_.count = 0;
+        for (section_.last = section_.first; section_.last != last_; ++section_.last) {
+            if (ast::is_comment(*section_.last)) continue;
+
+            next_kind_ = find_keyword(command_, *section_.last);
+            if (next_kind_ || section_.count == max_count) break;
+            ++section_.count;
+        }
+    }
+}
@@ -0,0 +1,517 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include <shipwright/ast/ast.hpp>
+
+namespace shipwright::commands {
+    enum class builtin_command
+    {
+        add_custom_command,
+        add_custom_target,
+        add_executable,
+        add_library,
+        add_test,
+        cmake_minimum_required,
+        find_package,
+        install,
+        project,
+        set,
+        target_compile_definitions,
+        target_compile_options,
+        target_include_directories,
+        target_link_libraries,
+        target_sources,
+    };
+
+    // Command names are case-insensitive, as they are to CMake.
+    std::optional<builtin_command> find_builtin_command(std::string_view name);
+
+    // Which values a keyword takes, as with the options, one-value keywords and multi-value
+    // keywords given to `cmake_parse_arguments`
+    enum class keyword_kind
+    {
+        // Takes no values. The arguments following it are positional again.
+        option,
+        // Takes the value following it, if that isn't a keyword. Any after it are positional.
+        one_value,
+        // Takes every value up to the next keyword
+        multi_value,
+    };
+
+    struct keyword
+    {
+        std::string_view name;
+        keyword_kind kind;
+    };
+
+    inline constexpr keyword add_custom_command_keywords[] = {
+        {"OUTPUT", keyword_kind::multi_value},
+        {"COMMAND", keyword_kind::multi_value},
+        {"MAIN_DEPENDENCY", keyword_kind::one_value},
+        {"DEPENDS", keyword_kind::multi_value},
+        {"BYPRODUCTS", keyword_kind::multi_value},
+        {"IMPLICIT_DEPENDS", keyword_kind::multi_value},
+        {"WORKING_DIRECTORY", keyword_kind::one_value},
+        {"COMMENT", keyword_kind::one_value},
+        {"DEPFILE", keyword_kind::one_value},
+        {"VERBATIM", keyword_kind::option},
+        {"APPEND", keyword_kind::option},
+        {"USES_TERMINAL", keyword_kind::option},
+        {"COMMAND_EXPAND_LISTS", keyword_kind::option},
+        {"TARGET", keyword_kind::one_value},
+        {"PRE_BUILD", keyword_kind::option},
+        {"PRE_LINK", keyword_kind::option},
+        {"POST_BUILD", keyword_kind::option},
+        {"JOB_POOL", keyword_kind::one_value},
+    };
+
+    inline constexpr keyword add_custom_target_keywords[] = {
+        {"ALL", keyword_kind::option},
+        {"COMMAND", keyword_kind::multi_value},
+        {"DEPENDS", keyword_kind::multi_value},
+        {"BYPRODUCTS", keyword_kind::multi_value},
+        {"WORKING_DIRECTORY", keyword_kind::one_value},
+        {"COMMENT", keyword_kind::one_value},
+        {"JOB_POOL", keyword_kind::one_value},
+        {"VERBATIM", keyword_kind::option},
+        {"USES_TERMINAL", keyword_kind::option},
+        {"COMMAND_EXPAND_LISTS", keyword_kind::option},
+        {"SOURCES", keyword_kind::multi_value},
+    };
+
+    inline constexpr keyword add_executable_keywords[] = {
+        {"WIN32", keyword_kind::option},
+        {"MACOSX_BUNDLE", keyword_kind::option},
+        {"EXCLUDE_FROM_ALL", keyword_kind::option},
+        {"IMPORTED", keyword_kind::option},
+        {"GLOBAL", keyword_kind::option},
+        {"ALIAS", keyword_kind::one_value},
+    };
+
+    inline constexpr keyword add_library_keywords[] = {
+        {"STATIC", keyword_kind::option},
+        {"SHARED", keyword_kind::option},
+        {"MODULE", keyword_kind::option},
+        {"OBJECT", keyword_kind::option},
+        {"INTERFACE", keyword_kind::option},
+        {"UNKNOWN", keyword_kind::option},
+        {"IMPORTED", keyword_kind::option},
+        {"GLOBAL", keyword_kind::option},
+        {"ALIAS", keyword_kind::one_value},
+        {"EXCLUDE_FROM_ALL", keyword_kind::option},
+    };
+
+    inline constexpr keyword add_test_keywords[] = {
+        {"NAME", keyword_kind::one_value},
+        {"COMMAND", keyword_kind::multi_value},
+        {"CONFIGURATIONS", keyword_kind::multi_value},
+        {"WORKING_DIRECTORY", keyword_kind::one_value},
+    };
+
+    inline constexpr keyword cmake_minimum_required_keywords[] = {
+        {"VERSION", keyword_kind::one_value},
+        {"FATAL_ERROR", keyword_kind::option},
+    };
+
+    inline constexpr keyword find_package_keywords[] = {
+        {"EXACT", keyword_kind::option},
+        {"QUIET", keyword_kind::option},
+        {"MODULE", keyword_kind::option},
+        {"CONFIG", keyword_kind::option},
+        {"NO_MODULE", keyword_kind::option},
+        // Optionally followed by components, as if by COMPONENTS
+        {"REQUIRED", keyword_kind::multi_value},
+        {"COMPONENTS", keyword_kind::multi_value},
+        {"OPTIONAL_COMPONENTS", keyword_kind::multi_value},
+        {"NO_POLICY_SCOPE", keyword_kind::option},
+        {"NAMES", keyword_kind::multi_value},
+        {"CONFIGS", keyword_kind::multi_value},
+        {"HINTS", keyword_kind::multi_value},
+        {"PATHS", keyword_kind::multi_value},
+        {"PATH_SUFFIXES", keyword_kind::multi_value},
+        {"NO_DEFAULT_PATH", keyword_kind::option},
+        {"NO_PACKAGE_ROOT_PATH", keyword_kind::option},
+        {"NO_CMAKE_PATH", keyword_kind::option},
+        {"NO_CMAKE_ENVIRONMENT_PATH", keyword_kind::option},
+        {"NO_SYSTEM_ENVIRONMENT_PATH", keyword_kind::option},
+        {"NO_CMAKE_PACKAGE_REGISTRY", keyword_kind::option},
+        {"NO_CMAKE_SYSTEM_PATH", keyword_kind::option},
+        {"NO_CMAKE_SYSTEM_PACKAGE_REGISTRY", keyword_kind::option},
+        {"CMAKE_FIND_ROOT_PATH_BOTH", keyword_kind::option},
+    };
+
+    inline constexpr keyword install_keywords[] = {
+        {"TARGETS", keyword_kind::multi_value},
+        {"FILES", keyword_kind::multi_value},
+        {"PROGRAMS", keyword_kind::multi_value},
+        {"DIRECTORY", keyword_kind::multi_value},
+        {"SCRIPT", keyword_kind::one_value},
+        {"CODE", keyword_kind::one_value},
+        {"EXPORT", keyword_kind::one_value},
+        {"DESTINATION", keyword_kind::one_value},
+        {"PERMISSIONS", keyword_kind::multi_value},
+        {"CONFIGURATIONS", keyword_kind::multi_value},
+        {"COMPONENT", keyword_kind::one_value},
+        {"NAMELINK_COMPONENT", keyword_kind::one_value},
+        {"OPTIONAL", keyword_kind::option},
+        {"EXCLUDE_FROM_ALL", keyword_kind::option},
+        {"RENAME", keyword_kind::one_value},
+        {"ARCHIVE", keyword_kind::option},
+        {"LIBRARY", keyword_kind::option},
+        {"RUNTIME", keyword_kind::option},
+        {"OBJECTS", keyword_kind::option},
+        {"FRAMEWORK", keyword_kind::option},
+        {"BUNDLE", keyword_kind::option},
+        {"PRIVATE_HEADER", keyword_kind::option},
+        {"PUBLIC_HEADER", keyword_kind::option},
+        {"RESOURCE", keyword_kind::option},
+        // Followed by DESTINATION
+        {"INCLUDES", keyword_kind::option},
+        {"NAMELINK_ONLY", keyword_kind::option},
+        {"NAMELINK_SKIP", keyword_kind::option},
+        {"TYPE", keyword_kind::one_value},
+        {"FILES_MATCHING", keyword_kind::option},
+        {"PATTERN", keyword_kind::one_value},
+        {"REGEX", keyword_kind::one_value},
+        {"EXCLUDE", keyword_kind::option},
+        {"USE_SOURCE_PERMISSIONS", keyword_kind::option},
+        {"FILE_PERMISSIONS", keyword_kind::multi_value},
+        {"DIRECTORY_PERMISSIONS", keyword_kind::multi_value},
+        {"MESSAGE_NEVER", keyword_kind::option},
+        {"NAMESPACE", keyword_kind::one_value},
+        {"FILE", keyword_kind::one_value},
+        {"EXPORT_LINK_INTERFACE_LIBRARIES", keyword_kind::option},
+        {"EXPORT_ANDROID_MK", keyword_kind::one_value},
+        {"ALL_COMPONENTS", keyword_kind::option},
+    };
+
+    inline constexpr keyword project_keywords[] = {
+        {"VERSION", keyword_kind::one_value},
+        {"DESCRIPTION", keyword_kind::one_value},
+        {"HOMEPAGE_URL", keyword_kind::one_value},
+        {"LANGUAGES", keyword_kind::multi_value},
+    };
+
+    inline constexpr keyword set_keywords[] = {
+        // Followed by the type and the docstring
+        {"CACHE", keyword_kind::multi_value},
+        {"FORCE", keyword_kind::option},
+        {"PARENT_SCOPE", keyword_kind::option},
+    };
+
+    inline constexpr keyword target_compile_definitions_keywords[] = {
+        {"INTERFACE", keyword_kind::multi_value},
+        {"PUBLIC", keyword_kind::multi_value},
+        {"PRIVATE", keyword_kind::multi_value},
+    };
+
+    inline constexpr keyword target_compile_options_keywords[] = {
+        {"BEFORE", keyword_kind::option},
+        {"INTERFACE", keyword_kind::multi_value},
+        {"PUBLIC", keyword_kind::multi_value},
+        {"PRIVATE", keyword_kind::multi_value},
+    };
+
+    inline constexpr keyword target_include_directories_keywords[] = {
+        {"SYSTEM", keyword_kind::option},
+        {"AFTER", keyword_kind::option},
+        {"BEFORE", keyword_kind::option},
+        {"INTERFACE", keyword_kind::multi_value},
+        {"PUBLIC", keyword_kind::multi_value},
+        {"PRIVATE", keyword_kind::multi_value},
+    };
+
+    inline constexpr keyword target_link_libraries_keywords[] = {
+        {"PUBLIC", keyword_kind::multi_value},
+        {"PRIVATE", keyword_kind::multi_value},
+        {"INTERFACE", keyword_kind::multi_value},
+        {"LINK_PUBLIC", keyword_kind::multi_value},
+        {"LINK_PRIVATE", keyword_kind::multi_value},
+        {"LINK_INTERFACE_LIBRARIES", keyword_kind::multi_value},
+    };
+
+    inline constexpr keyword target_sources_keywords[] = {
+        {"INTERFACE", keyword_kind::multi_value},
+        {"PUBLIC", keyword_kind::multi_value},
+        {"PRIVATE", keyword_kind::multi_value},
+    };
+
+    // The keywords of one command, viewing one of the arrays above
+    class keyword_schema
+    {
+    public:
+        constexpr keyword_schema() = default;
+
+        template <std::size_t N>
+        constexpr keyword_schema(keyword const (&keywords)[N])
+            : first_{keywords}
+            , last_{keywords + N}
+        {}
+
+        constexpr keyword const* begin() const
+        {
+            return first_;
+        }
+
+        constexpr keyword const* end() const
+        {
+            return last_;
+        }
+
+        constexpr std::size_t size() const
+        {
+            return static_cast<std::size_t>(last_ - first_);
+        }
+
+    private:
+        keyword const* first_ = nullptr;
+        keyword const* last_ = nullptr;
+    };
+
+    constexpr keyword_schema schema_of(builtin_command command)
+    {
+        switch (command) {
+        case builtin_command::add_custom_command: return add_custom_command_keywords;
+        case builtin_command::add_custom_target: return add_custom_target_keywords;
+        case builtin_command::add_executable: return add_executable_keywords;
+        case builtin_command::add_library: return add_library_keywords;
+        case builtin_command::add_test: return add_test_keywords;
+        case builtin_command::cmake_minimum_required: return cmake_minimum_required_keywords;
+        case builtin_command::find_package: return find_package_keywords;
+        case builtin_command::install: return install_keywords;
+        case builtin_command::project: return project_keywords;
+        case builtin_command::set: return set_keywords;
+        case builtin_command::target_compile_definitions:
+            return target_compile_definitions_keywords;
+        case builtin_command::target_compile_options: return target_compile_options_keywords;
+        case builtin_command::target_include_directories:
+            return target_include_directories_keywords;
+        case builtin_command::target_link_libraries: return target_link_libraries_keywords;
+        case builtin_command::target_sources: return target_sources_keywords;
+        }
+
+        return {};
+    }
+
+    // The kind of `argument` if it is one of `command`'s keywords, which start new sections
+    // of its arguments. Keywords are case-sensitive.
+    std::optional<keyword_kind> find_keyword(builtin_command command, std::string_view argument);
+
+    // As above, if `argument` is unquoted. A quoted "PUBLIC" is a value, not a keyword.
+    std::optional<keyword_kind> find_keyword(
+        builtin_command command, ast::argument const& argument);
+
+    // Whether `argument` starts a new section of `command`'s arguments.
+    // Keywords are case-sensitive.
+    bool is_keyword(builtin_command command, std::string_view argument);
+
+    // Whether `argument` is an unquoted keyword of `command`.
+    // A quoted "PUBLIC" is a value, not a keyword.
+    bool is_keyword(builtin_command command, ast::argument const& argument);
+
+    struct keyword_section
+    {
+        class iterator;
+
+        // Empty for the arguments before the first keyword.
+        std::string_view keyword;
+        // The values following the keyword: none for an option, at most one for a one-value
+        // keyword, and up to the next keyword otherwise. Any comments among or after them are
+        // in this range, but are skipped by `begin()`/`end()`.
+        ast::argument const* first;
+        ast::argument const* last;
+        // The number of arguments in `[first, last)` which aren't comments
+        std::size_t count;
+
+        std::size_t size() const
+        {
+            return count;
+        }
+
+        iterator begin() const;
+        iterator end() const;
+    };
+
+    class keyword_section::iterator
+    {
+    public:
+        using difference_type = std::ptrdiff_t;
+        using value_type = ast::argument;
+        using pointer = value_type const*;
+        using reference = value_type const&;
+        using iterator_category = std::forward_iterator_tag;
+
+        iterator() = default;
+
+        iterator(ast::argument const* position, ast::argument const* last)
+            : position_{position}
+            , last_{last}
+        {
+            skip_comments();
+        }
+
+        reference operator*() const
+        {
+            return *position_;
+        }
+
+        pointer operator->() const
+        {
+            return position_;
+        }
+
+        iterator& operator++()
+        {
+            ++position_;
+            skip_comments();
+            return *this;
+        }
+
+        iterator operator++(int)
+        {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        friend bool operator==(iterator const& lhs, iterator const& rhs)
+        {
+            return lhs.position_ == rhs.position_;
+        }
+
+        friend bool operator!=(iterator const& lhs, iterator const& rhs)
+        {
+            return !(lhs == rhs);
+        }
+
+    private:
+        void skip_comments()
+        {
+            while (position_ != last_ && ast::is_comment(*position_)) {
+                ++position_;
+            }
+        }
+
+        ast::argument const* position_ = nullptr;
+        ast::argument const* last_ = nullptr;
+    };
+
+    inline keyword_section::iterator keyword_section::begin() const
+    {
+        return iterator{first, last};
+    }
+
+    inline keyword_section::iterator keyword_section::end() const
+    {
+        return iterator{last, last};
+    }
+
+    // Lazily groups the arguments of a command invocation into keyword sections.
+    // Each argument is inspected exactly once over a full iteration, and nothing is allocated.
+    //
+    // Positional arguments form sections with an empty keyword: those before the first keyword,
+    // and those following the values an option or one-value keyword takes, up to the next
+    // keyword. Every keyword forms a section, even if it takes no values. Comments never form
+    // a section of their own.
+    class keyword_sections
+    {
+    public:
+        class iterator;
+
+        keyword_sections(builtin_command command, std::vector<ast::argument> const& arguments)
+            : command_{command}
+            , first_{arguments.data()}
+            , last_{arguments.data() + arguments.size()}
+        {}
+
+        iterator begin() const;
+        iterator end() const;
+
+    private:
+        builtin_command command_;
+        ast::argument const* first_;
+        ast::argument const* last_;
+    };
+
+    class keyword_sections::iterator
+    {
+    public:
+        using difference_type = std::ptrdiff_t;
+        using value_type = keyword_section;
+        using pointer = value_type const*;
+        using reference = value_type const&;
+        using iterator_category = std::forward_iterator_tag;
+
+        iterator() = default;
+
+        iterator(builtin_command command, ast::argument const* position, ast::argument const* last);
+
+        reference operator*() const
+        {
+            return section_;
+        }
+
+        pointer operator->() const
+        {
+            return &section_;
+        }
+
+        iterator& operator++()
+        {
+            load(section_.last, next_kind_);
+            return *this;
+        }
+
+        iterator operator++(int)
+        {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        friend bool operator==(iterator const& lhs, iterator const& rhs)
+        {
+            return lhs.position_ == rhs.position_;
+        }
+
+        friend bool operator!=(iterator const& lhs, iterator const& rhs)
+        {
+            return !(lhs == rhs);
+        }
+
+    private:
+        // `kind` is that of the keyword at `position`, if there is one there
+        void load(ast::argument const* position, std::optional<keyword_kind> kind);
+
+        builtin_command command_ = {};
+        // Where the current section starts, including its keyword
+        ast::argument const* position_ = nullptr;
+        ast::argument const* last_ = nullptr;
+        keyword_section section_ = {};
+        // The kind of the keyword ending the current section, if a keyword ends it, found while
+        // loading the section so that no argument need be looked up twice
+        std::optional<keyword_kind> next_kind_;
+    };
+
+    inline keyword_sections::iterator keyword_sections::begin() const
+    {
+        return iterator{command_, first_, last_};
+    }
+
+    inline keyword_sections::iterator keyword_sections::end() const
+    {
+        return iterator{command_, last_, last_};
+    }
+}
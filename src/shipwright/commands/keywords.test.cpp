@@ -0,0 +1,267 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "./keywords.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using shipwright::commands::builtin_command;
+using shipwright::commands::find_builtin_command;
+using shipwright::commands::is_keyword;
+using shipwright::commands::keyword_sections;
+namespace ast = shipwright::ast;
+
+namespace {
+    ast::argument unquoted(std::string_view value)
+    {
+        return ast::argument{ast::unquoted_argument{value}};
+    }
+
+    ast::argument quoted(std::string_view value)
+    {
+        return ast::argument{ast::quoted_argument{value}};
+    }
+
+    ast::argument comment(std::string_view value)
+    {
+        return ast::argument{ast::line_comment{value}};
+    }
+
+    // (keyword, number of arguments) for each section
+    std::vector<std::pair<std::string, std::size_t>> sections_of(
+        builtin_command command, std::vector<ast::argument> const& arguments)
+    {
+        std::vector<std::pair<std::string, std::size_t>> result;
+        for (auto const& section : keyword_sections{command, arguments}) {
+            result.emplace_back(section.keyword, section.size());
+        }
+        return result;
+    }
+}
+
+TEST_CASE("Builtin commands are found case-insensitively", "[commands]")
+{
+    CHECK(find_builtin_command("target_link_libraries") == builtin_command::target_link_libraries);
+    CHECK(find_builtin_command("TARGET_LINK_LIBRARIES") == builtin_command::target_link_libraries);
+    CHECK(find_builtin_command("Add_Library") == builtin_command::add_library);
+    CHECK_FALSE(find_builtin_command("my_function"));
+    CHECK_FALSE(find_builtin_command(""));
+    CHECK_FALSE(find_builtin_command(std::string(100, 'a')));
+}
+
+TEST_CASE("Keywords are case-sensitive and must be unquoted", "[commands]")
+{
+    CHECK(is_keyword(builtin_command::target_link_libraries, "PUBLIC"));
+    CHECK_FALSE(is_keyword(builtin_command::target_link_libraries, "public"));
+    CHECK_FALSE(is_keyword(builtin_command::target_link_libraries, "STATIC"));
+    CHECK(is_keyword(builtin_command::add_library, "STATIC"));
+
+    CHECK(is_keyword(builtin_command::install, unquoted("DESTINATION")));
+    CHECK_FALSE(is_keyword(builtin_command::install, quoted("DESTINATION")));
+}
+
+TEST_CASE("Arguments are grouped into keyword sections", "[commands]")
+{
+    SECTION("Leading arguments form their own section")
+    {
+        std::vector const arguments{
+            unquoted("foo"),
+            unquoted("PUBLIC"),
+            unquoted("bar"),
+            unquoted("baz"),
+            unquoted("PRIVATE"),
+            quoted("PUBLIC"),
+        };
+
+        CHECK(sections_of(builtin_command::target_link_libraries, arguments)
+            == std::vector<std::pair<std::string, std::size_t>>{
+                {"", 1},
+                {"PUBLIC", 2},
+                {"PRIVATE", 1},
+            });
+    }
+
+    SECTION("Empty sections are kept")
+    {
+        std::vector const arguments{
+            unquoted("TARGETS"),
+            unquoted("foo"),
+            unquoted("OPTIONAL"),
+            unquoted("DESTINATION"),
+            unquoted("lib"),
+            unquoted("EXCLUDE_FROM_ALL"),
+        };
+
+        CHECK(sections_of(builtin_command::install, arguments)
+            == std::vector<std::pair<std::string, std::size_t>>{
+                {"TARGETS", 1},
+                {"OPTIONAL", 0},
+                {"DESTINATION", 1},
+                {"EXCLUDE_FROM_ALL", 0},
+            });
+    }
+
+    SECTION("No arguments")
+    {
+        CHECK(sections_of(builtin_command::add_library, {}).empty());
+    }
+
+    SECTION("Comments are not counted")
+    {
+        std::vector const arguments{
+            comment(" leading"),
+            unquoted("foo"),
+            comment(" PUBLIC"),
+            unquoted("PUBLIC"),
+            comment(" first"),
+            unquoted("bar"),
+            ast::argument{ast::bracket_comment{{"second", 0}}},
+            unquoted("PRIVATE"),
+            comment(" only"),
+        };
+
+        CHECK(sections_of(builtin_command::target_link_libraries, arguments)
+            == std::vector<std::pair<std::string, std::size_t>>{
+                {"", 1},
+                {"PUBLIC", 1},
+                {"PRIVATE", 0},
+            });
+
+        auto const sections = keyword_sections{builtin_command::target_link_libraries, arguments};
+        auto const public_section = *std::next(sections.begin());
+        REQUIRE(std::distance(public_section.begin(), public_section.end()) == 1);
+        CHECK(&*public_section.begin() == &arguments[5]);
+    }
+
+    SECTION("Comments alone form no section")
+    {
+        CHECK(sections_of(builtin_command::add_library, {comment(" nothing")}).empty());
+    }
+
+    SECTION("Sections refer to the original arguments")
+    {
+        std::vector const arguments{
+            unquoted("foo"),
+            unquoted("STATIC"),
+            unquoted("foo.cpp"),
+        };
+
+        auto const sections = keyword_sections{builtin_command::add_library, arguments};
+        auto it = sections.begin();
+        REQUIRE(it != sections.end());
+        CHECK(it->first == &arguments[0]);
+        CHECK(it->last == &arguments[1]);
+        ++it;
+        REQUIRE(it != sections.end());
+        CHECK(it->keyword == "STATIC");
+        CHECK(it->first == &arguments[2]);
+        CHECK(it->last == &arguments[2]);
+        ++it;
+        REQUIRE(it != sections.end());
+        CHECK(it->keyword.empty());
+        CHECK(it->first == &arguments[2]);
+        CHECK(it->last == arguments.data() + arguments.size());
+        ++it;
+        CHECK(it == sections.end());
+    }
+}
+
+TEST_CASE("Keywords take values according to their kind", "[commands]")
+{
+    SECTION("Options take no values")
+    {
+        std::vector const arguments{
+            unquoted("foo"),
+            unquoted("STATIC"),
+            comment(" sources"),
+            unquoted("a.cpp"),
+            unquoted("b.cpp"),
+            unquoted("EXCLUDE_FROM_ALL"),
+        };
+
+        CHECK(sections_of(builtin_command::add_library, arguments)
+            == std::vector<std::pair<std::string, std::size_t>>{
+                {"", 1},
+                {"STATIC", 0},
+                {"", 2},
+                {"EXCLUDE_FROM_ALL", 0},
+            });
+    }
+
+    SECTION("One-value keywords take one value")
+    {
+        std::vector const arguments{
+            unquoted("FILES"),
+            unquoted("a.h"),
+            unquoted("DESTINATION"),
+            unquoted("include"),
+            comment(" stray"),
+            unquoted("extra"),
+            unquoted("RENAME"),
+            unquoted("OPTIONAL"),
+        };
+
+        CHECK(sections_of(builtin_command::install, arguments)
+            == std::vector<std::pair<std::string, std::size_t>>{
+                {"FILES", 1},
+                {"DESTINATION", 1},
+                {"", 1},
+                {"RENAME", 0},
+                {"OPTIONAL", 0},
+            });
+    }
+
+    SECTION("Multi-value keywords take values up to the next keyword")
+    {
+        std::vector const arguments{
+            unquoted("x"),
+            unquoted("LANGUAGES"),
+            unquoted("C"),
+            unquoted("CXX"),
+            unquoted("VERSION"),
+            unquoted("1.0"),
+        };
+
+        CHECK(sections_of(builtin_command::project, arguments)
+            == std::vector<std::pair<std::string, std::size_t>>{
+                {"", 1},
+                {"LANGUAGES", 2},
+                {"VERSION", 1},
+            });
+    }
+}
+
+TEST_CASE("Keyword schemas are available at compile time", "[commands]")
+{
+    using shipwright::commands::find_keyword;
+    using shipwright::commands::keyword_kind;
+    using shipwright::commands::schema_of;
+
+    static_assert(schema_of(builtin_command::add_library).size() == 10);
+    static_assert(schema_of(builtin_command::set).begin()->name == "CACHE");
+
+    CHECK(find_keyword(builtin_command::add_library, "STATIC") == keyword_kind::option);
+    CHECK(find_keyword(builtin_command::install, "DESTINATION") == keyword_kind::one_value);
+    CHECK(find_keyword(builtin_command::target_sources, "PUBLIC") == keyword_kind::multi_value);
+    CHECK_FALSE(find_keyword(builtin_command::target_sources, quoted("PUBLIC")));
+    CHECK_FALSE(find_keyword(builtin_command::target_sources, "STATIC"));
+
+    // Every keyword in every schema is found with the kind it is listed with
+    for (auto command = builtin_command::add_custom_command;
+         command <= builtin_command::target_sources;
+         command = static_cast<builtin_command>(static_cast<int>(command) + 1)) {
+        for (auto const& keyword : schema_of(command)) {
+            CAPTURE(keyword.name);
+            CHECK(find_keyword(command, keyword.name) == keyword.kind);
+        }
+    }
+}
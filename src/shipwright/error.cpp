@@ -0,0 +1,43 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "./error.hpp"
+
+#include <cassert>
+#include <ostream>
+#include <string_view>
+
+#include <frozen/map.h>
+
+using shipwright::error_kind;
+
+namespace {
+    constexpr auto kind_stringify = frozen::make_map<error_kind, std::string_view>({
+        {error_kind::syntax_error, "syntax_error"},
+        {error_kind::too_many_bytes, "too_many_bytes"},
+        {error_kind::too_many_tokens, "too_many_tokens"},
+        {error_kind::token_too_long, "token_too_long"},
+        {error_kind::too_deeply_nested, "too_deeply_nested"},
+        {error_kind::too_many_ast_nodes, "too_many_ast_nodes"},
+        {error_kind::too_many_ast_bytes, "too_many_ast_bytes"},
+    });
+}
+
+namespace shipwright {
+    std::ostream& operator<<(std::ostream& lhs, debug_print<error_kind> const& rhs)
+    {
+        auto const lookup = kind_stringify.find(rhs.value);
+        assert(lookup != kind_stringify.end());
+
+        return lhs << lookup->second;
+    }
+
+    std::ostream& operator<<(std::ostream& lhs, debug_print<parse_error> const& rhs)
+    {
+        return lhs << '<' << shipwright::debug_print(rhs.value.kind) << " at " << rhs.value.offset
+                   << ": \"" << rhs.value.message << "\">";
+    }
+}
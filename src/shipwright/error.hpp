@@ -0,0 +1,40 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+
+#include <shipwright/debug_print.hpp>
+
+namespace shipwright {
+    enum class error_kind
+    {
+        syntax_error,
+
+        // Each corresponds to a member of `shipwright::limits`
+        too_many_bytes,
+        too_many_tokens,
+        token_too_long,
+        too_deeply_nested,
+        too_many_ast_nodes,
+        too_many_ast_bytes,
+    };
+
+    std::ostream& operator<<(std::ostream& lhs, debug_print<error_kind> const& rhs);
+
+    struct parse_error
+    {
+        error_kind kind;
+        // Offset into the input where the error was noticed
+        std::size_t offset;
+        std::string message;
+    };
+
+    std::ostream& operator<<(std::ostream& lhs, debug_print<parse_error> const& rhs);
+}
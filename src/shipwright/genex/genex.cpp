@@ -0,0 +1,203 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "./genex.hpp"
+
+#include <limits>
+
+namespace {
+    using shipwright::genex::node;
+    using shipwright::genex::node_kind;
+
+    // Builds the tree with an explicit stack rather than recursion, so arbitrarily deep
+    // nesting can't overflow the call stack.
+    class builder
+    {
+    public:
+        explicit builder(std::vector<node>& nodes)
+            : nodes_{nodes}
+        {
+            nodes_.push_back(node{node_kind::parameter, 0, 0, 0, 0});
+            frames_.push_back(frame{0, 0, 0, false});
+        }
+
+        void literal_char(std::uint32_t pos)
+        {
+            if (literal_start_ == no_literal) literal_start_ = pos;
+        }
+
+        void open_expression(std::uint32_t pos)
+        {
+            flush_literal(pos);
+
+            auto const expression = append_child(node_kind::expression, pos);
+            auto const name = add_node(node_kind::parameter, pos + 2);
+            nodes_[expression].first_child = name;
+
+            frames_.push_back(frame{expression, name, 0, true});
+        }
+
+        // Whether `c` separates parameters of the current expression
+        bool is_separator(char c) const
+        {
+            if (frames_.size() == 1) return false;
+
+            auto const& top = frames_.back();
+            return top.in_name ? c == ':' : c == ',';
+        }
+
+        void separate(std::uint32_t pos)
+        {
+            flush_literal(pos);
+            close_parameter(pos);
+
+            auto& top = frames_.back();
+            auto const param = add_node(node_kind::parameter, pos + 1);
+            nodes_[top.parameter].next_sibling = param;
+
+            top.parameter = param;
+            top.last_child = 0;
+            top.in_name = false;
+        }
+
+        bool can_close() const
+        {
+            return frames_.size() > 1;
+        }
+
+        void close_expression(std::uint32_t pos)
+        {
+            flush_literal(pos);
+            close_parameter(pos);
+
+            auto& expression = nodes_[frames_.back().expression];
+            expression.length = pos + 1 - expression.offset;
+            frames_.pop_back();
+        }
+
+        // Closes everything still open at the end of the text.
+        // Returns the offset of the outermost unclosed expression, if any.
+        std::optional<std::size_t> finish(std::uint32_t end)
+        {
+            flush_literal(end);
+
+            std::optional<std::size_t> unclosed;
+            while (frames_.size() > 1) {
+                close_parameter(end);
+                auto& expression = nodes_[frames_.back().expression];
+                expression.length = end - expression.offset;
+                unclosed = expression.offset;
+                frames_.pop_back();
+            }
+
+            nodes_.front().length = end;
+            return unclosed;
+        }
+
+    private:
+        static constexpr auto no_literal = std::numeric_limits<std::uint32_t>::max();
+
+        struct frame
+        {
+            // 0 at the root
+            std::uint32_t expression;
+            // The parameter currently being filled in
+            std::uint32_t parameter;
+            // The last child of `parameter`, or 0 if it has none yet
+            std::uint32_t last_child;
+            // Whether `parameter` is the expression's name, which ends at the first `:`
+            bool in_name;
+        };
+
+        std::uint32_t add_node(node_kind kind, std::uint32_t pos)
+        {
+            nodes_.push_back(node{kind, pos, 0, 0, 0});
+            return static_cast<std::uint32_t>(nodes_.size() - 1);
+        }
+
+        std::uint32_t append_child(node_kind kind, std::uint32_t pos)
+        {
+            auto const child = add_node(kind, pos);
+
+            auto& top = frames_.back();
+            if (top.last_child == 0) {
+                nodes_[top.parameter].first_child = child;
+            } else {
+                nodes_[top.last_child].next_sibling = child;
+            }
+            top.last_child = child;
+
+            return child;
+        }
+
+        void flush_literal(std::uint32_t pos)
+        {
+            if (literal_start_ == no_literal) return;
+
+            auto const literal = append_child(node_kind::literal, literal_start_);
+            nodes_[literal].length = pos - literal_start_;
+            literal_start_ = no_literal;
+        }
+
+        void close_parameter(std::uint32_t pos)
+        {
+            auto& param = nodes_[frames_.back().parameter];
+            param.length = pos - param.offset;
+        }
+
+        std::vector<node>& nodes_;
+        std::vector<frame> frames_;
+        std::uint32_t literal_start_ = no_literal;
+    };
+}
+
+namespace shipwright::genex {
+    bool contains_genex(std::string_view text)
+    {
+        return text.find("$<") != std::string_view::npos;
+    }
+
+    tree parse(std::string_view text)
+    {
+        tree result;
+        result.source_ = text;
+
+        ::builder builder{result.nodes_};
+        if (text.size() > max_text_bytes) {
+            result.too_long_ = true;
+            return result;
+        }
+
+        auto const size = static_cast<std::uint32_t>(text.size());
+        for (std::uint32_t pos = 0; pos < size; ++pos) {
+            auto const c = text[pos];
+
+            if (c == '$' && pos + 1 < size && text[pos + 1] == '<') {
+                builder.open_expression(pos);
+                ++pos;
+            } else if (c == '>' && builder.can_close()) {
+                builder.close_expression(pos);
+            } else if (builder.is_separator(c)) {
+                builder.separate(pos);
+            } else {
+                builder.literal_char(pos);
+            }
+        }
+
+        result.error_offset_ = builder.finish(size);
+        return result;
+    }
+
+    tree const& cache::get(std::string_view text)
+    {
+        auto const key = std::pair{text.data(), text.size()};
+
+        auto const it = trees_.find(key);
+        if (it != trees_.end()) return it->second;
+
+        return trees_.emplace(key, genex::parse(text)).first->second;
+    }
+}
@@ -0,0 +1,152 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <shipwright/ast/ast.hpp>
+
+namespace shipwright::genex {
+    enum class node_kind : std::uint8_t
+    {
+        // Plain text
+        literal,
+        // `$<...>`. Its children are its parameters: first the name, then each argument.
+        expression,
+        // A sequence of literals and expressions: the name or an argument of an expression,
+        // or the whole text at the root.
+        parameter,
+    };
+
+    // The longest text `parse` accepts, so that any offset into it fits in a node
+    constexpr std::size_t max_text_bytes = std::numeric_limits<std::uint32_t>::max() - 1;
+
+    struct node
+    {
+        node_kind kind;
+        // The span of text covered by this node, relative to the parsed text.
+        std::uint32_t offset;
+        std::uint32_t length;
+        // Indices into the tree. The root is never anyone's child or sibling, so 0 means none.
+        std::uint32_t first_child;
+        std::uint32_t next_sibling;
+    };
+
+    // The generator expressions of an argument, as a flat tree of spans into the argument's text.
+    // Nothing is copied out of the text, which must outlive the tree.
+    class tree
+    {
+    public:
+        std::string_view source() const
+        {
+            return source_;
+        }
+
+        node const& root() const
+        {
+            return nodes_.front();
+        }
+
+        std::string_view text(node const& n) const
+        {
+            return source_.substr(n.offset, n.length);
+        }
+
+        node const* first_child(node const& n) const
+        {
+            return n.first_child == 0 ? nullptr : &nodes_[n.first_child];
+        }
+
+        node const* next_sibling(node const& n) const
+        {
+            return n.next_sibling == 0 ? nullptr : &nodes_[n.next_sibling];
+        }
+
+        std::size_t size() const
+        {
+            return nodes_.size();
+        }
+
+        // The offset of the first `$<` which is never closed, if any.
+        // Unclosed expressions extend to the end of the text.
+        std::optional<std::size_t> error_offset() const
+        {
+            return error_offset_;
+        }
+
+        // Whether the text was longer than `max_text_bytes`. It is then not parsed at all,
+        // and the tree is only an empty root.
+        bool too_long() const
+        {
+            return too_long_;
+        }
+
+    private:
+        friend tree parse(std::string_view text);
+
+        std::string_view source_;
+        std::vector<node> nodes_;
+        std::optional<std::size_t> error_offset_;
+        bool too_long_ = false;
+    };
+
+    // Whether `text` could contain any generator expressions at all.
+    bool contains_genex(std::string_view text);
+
+    // Parses the generator expressions in `text`. Nesting depth is limited only by memory,
+    // but the length of `text` by `max_text_bytes`.
+    tree parse(std::string_view text);
+
+    // Lazily parses arguments, remembering the result for each.
+    // Arguments are identified by their text's address, so they must not move or be destroyed
+    // while the cache is in use.
+    class cache
+    {
+    public:
+        tree const& get(std::string_view text);
+
+        tree const& get(ast::unquoted_argument const& argument)
+        {
+            return get(argument.value);
+        }
+
+        tree const& get(ast::quoted_argument const& argument)
+        {
+            return get(argument.value);
+        }
+
+        // Brackets stop variable references being expanded, but not generator expressions
+        tree const& get(ast::bracket_argument const& argument)
+        {
+            return get(argument.value);
+        }
+
+        void clear()
+        {
+            trees_.clear();
+        }
+
+    private:
+        struct key_hash
+        {
+            std::size_t operator()(std::pair<char const*, std::size_t> const& key) const
+            {
+                return std::hash<char const*>{}(key.first) ^ std::hash<std::size_t>{}(key.second);
+            }
+        };
+
+        std::unordered_map<std::pair<char const*, std::size_t>, tree, key_hash> trees_;
+    };
+}
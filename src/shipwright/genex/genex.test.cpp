@@ -0,0 +1,147 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "./genex.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace genex = shipwright::genex;
+using genex::node;
+using genex::node_kind;
+
+namespace {
+    // Renders the tree back out with explicit structure:
+    // literals are quoted, expressions are `{name|arg|...}`
+    void render(genex::tree const& tree, node const& n, std::string& out)
+    {
+        switch (n.kind) {
+        case node_kind::literal:
+            out += '\'';
+            out += tree.text(n);
+            out += '\'';
+            break;
+        case node_kind::parameter:
+            for (auto child = tree.first_child(n); child; child = tree.next_sibling(*child)) {
+                render(tree, *child, out);
+            }
+            break;
+        case node_kind::expression:
+            out += '{';
+            for (auto param = tree.first_child(n); param; param = tree.next_sibling(*param)) {
+                if (param != tree.first_child(n)) out += '|';
+                render(tree, *param, out);
+            }
+            out += '}';
+            break;
+        }
+    }
+
+    std::string render(genex::tree const& tree)
+    {
+        std::string out;
+        render(tree, tree.root(), out);
+        return out;
+    }
+}
+
+TEST_CASE("Can parse generator expressions", "[genex]")
+{
+    auto [input, expected] = GENERATE(table<std::string, std::string>({
+        {"", ""},
+        {"-Wall", "'-Wall'"},
+        {"$<CONFIG>", "{'CONFIG'}"},
+        {"$<BOOL:${x}>", "{'BOOL'|'${x}'}"},
+        {"a$<IF:1,b,c>d", "'a'{'IF'|'1'|'b'|'c'}'d'"},
+        {"$<1:a:b>", "{'1'|'a:b'}"},
+        {"$<$<CXX_COMPILER_ID:GNU>:-Wno-unused-function>",
+            "{{'CXX_COMPILER_ID'|'GNU'}|'-Wno-unused-function'}"},
+        {"$<$<OR:$<CONFIG:DEBUG>,$<BOOL:x>>:--define=parse.assert=true>",
+            "{{'OR'|{'CONFIG'|'DEBUG'}|{'BOOL'|'x'}}|'--define=parse.assert=true'}"},
+        {"$<:>", "{|}"},
+        {"a>b,c:d", "'a>b,c:d'"},
+        {"$", "'$'"},
+    }));
+
+    CAPTURE(input);
+
+    auto const tree = genex::parse(input);
+    CHECK(render(tree) == expected);
+    CHECK_FALSE(tree.error_offset());
+    CHECK(tree.text(tree.root()) == input);
+}
+
+TEST_CASE("Spans refer into the original text", "[genex]")
+{
+    std::string const input = "x$<BOOL:y>";
+    auto const tree = genex::parse(input);
+
+    auto const* expression = tree.next_sibling(*tree.first_child(tree.root()));
+    REQUIRE(expression);
+    CHECK(tree.text(*expression) == "$<BOOL:y>");
+    CHECK(tree.text(*expression).data() == input.data() + 1);
+}
+
+TEST_CASE("Unclosed generator expressions are reported", "[genex]")
+{
+    auto const tree = genex::parse("a$<BOOL:$<CONFIG>");
+
+    CHECK(render(tree) == "'a'{'BOOL'|{'CONFIG'}}");
+    CHECK(tree.error_offset() == 1u);
+}
+
+TEST_CASE("Deeply nested generator expressions do not recurse", "[genex]")
+{
+    constexpr int depth = 100000;
+
+    std::string input;
+    for (int i = 0; i < depth; ++i) {
+        input += "$<a:";
+    }
+    input += std::string(depth, '>');
+
+    auto const tree = genex::parse(input);
+    CHECK_FALSE(tree.error_offset());
+    // Each level has an expression, its name, a literal name and its argument
+    CHECK(tree.size() == 1 + 4 * static_cast<std::size_t>(depth));
+}
+
+TEST_CASE("Texts too long for the tree's offsets are rejected", "[genex]")
+{
+    if constexpr (sizeof(std::size_t) > sizeof(std::uint32_t)) {
+        // Only its length is looked at, so the text is never read
+        std::string const input = "$<CONFIG>";
+        std::string_view const huge{input.data(), genex::max_text_bytes + 1};
+
+        auto const tree = genex::parse(huge);
+        CHECK(tree.too_long());
+        CHECK(tree.size() == 1);
+        CHECK(tree.root().length == 0);
+        CHECK_FALSE(tree.first_child(tree.root()));
+    }
+
+    CHECK_FALSE(genex::parse("$<CONFIG>").too_long());
+}
+
+TEST_CASE("The cache parses each argument once", "[genex]")
+{
+    std::string const input = "$<CONFIG:Debug>";
+    shipwright::ast::unquoted_argument const argument{input};
+
+    genex::cache cache;
+    auto const& first = cache.get(argument);
+    auto const& second = cache.get(argument);
+
+    CHECK(&first == &second);
+    CHECK(first.source().data() == input.data());
+
+    shipwright::ast::bracket_argument const bracket{input, 0};
+    CHECK(&cache.get(bracket) == &first);
+}
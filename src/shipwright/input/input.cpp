@@ -0,0 +1,82 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "./input.hpp"
+
+#include <memory>
+#include <string_view>
+
+namespace shipwright::input {
+    std::optional<loaded_input> load(std::FILE* in, load_options options)
+    {
+        constexpr std::size_t chunk_size = 64 * 1024;
+        // Enough to identify any byte order mark
+        constexpr std::size_t bom_window = 4;
+
+        loaded_input result;
+        utf8_validator validator;
+
+        // Bytes of `result.text` which have been validated
+        std::size_t validated = 0;
+        bool bom_checked = false;
+
+        // Bytes read from `in`, including any byte order mark
+        std::size_t total = 0;
+
+        for (;;) {
+            // Read at most one byte past `max_bytes`: enough to know the input is too large
+            auto const remaining = options.max_bytes - total;
+            auto const wanted = remaining < chunk_size ? remaining + 1 : chunk_size;
+
+            auto const old_size = result.text.size();
+            result.text.resize(old_size + wanted);
+            auto const length = std::fread(result.text.data() + old_size, 1, wanted, in);
+            result.text.resize(old_size + length);
+            total += length;
+
+            bool const eof = length == 0;
+            if (eof && std::ferror(in)) return std::nullopt;
+
+            if (total > options.max_bytes) {
+                return loaded_input{{}, byte_order_mark::none, std::nullopt, true};
+            }
+
+            if (!bom_checked && (eof || result.text.size() >= bom_window)) {
+                bom_checked = true;
+                result.bom = detect_bom(result.text);
+
+                // Only ever the first few bytes of the first chunk, so cheap to erase
+                if (result.bom == byte_order_mark::utf8 && options.strip_utf8_bom) {
+                    result.text.erase(0, bom_length(result.bom));
+                }
+            }
+
+            // Validate what was just read while it's still in cache
+            if (bom_checked && options.validate_utf8) {
+                validator.feed(std::string_view{result.text}.substr(validated));
+                validated = result.text.size();
+            }
+
+            if (eof) break;
+        }
+
+        if (options.validate_utf8) {
+            validator.finish();
+            result.invalid_utf8_offset = validator.error_offset();
+        }
+
+        return result;
+    }
+
+    std::optional<loaded_input> load_file(std::string const& path, load_options options)
+    {
+        std::unique_ptr<std::FILE, int (*)(std::FILE*)> file{
+            std::fopen(path.c_str(), "rb"), &std::fclose};
+        if (!file) return std::nullopt;
+
+        return input::load(file.get(), options);
+    }
+}
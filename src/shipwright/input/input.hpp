@@ -0,0 +1,48 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <limits>
+#include <optional>
+#include <string>
+
+#include <shipwright/input/utf8.hpp>
+
+namespace shipwright::input {
+    struct load_options
+    {
+        // Validate UTF-8 as the input is read
+        bool validate_utf8 = true;
+        // Stop reading once the input, counting any byte order mark, is known to be
+        // larger than this
+        std::size_t max_bytes = std::numeric_limits<std::size_t>::max();
+        // Remove a UTF-8 byte order mark from the text. Otherwise it is kept, so that offsets
+        // into the text are offsets into the input.
+        bool strip_utf8_bom = true;
+    };
+
+    struct loaded_input
+    {
+        // The contents, less any UTF-8 byte order mark if `strip_utf8_bom` was set
+        std::string text;
+        byte_order_mark bom = byte_order_mark::none;
+        // Offset into `text` of the first invalid UTF-8 sequence.
+        // Always empty if validation was not requested.
+        std::optional<std::size_t> invalid_utf8_offset;
+        // The input is larger than `max_bytes`, so was not read in full.
+        // Every other member is then empty.
+        bool too_large = false;
+    };
+
+    // Reads all of `in`. Returns `std::nullopt` on a read error.
+    std::optional<loaded_input> load(std::FILE* in, load_options options = {});
+
+    // Returns `std::nullopt` if the file could not be opened or read.
+    std::optional<loaded_input> load_file(std::string const& path, load_options options = {});
+}
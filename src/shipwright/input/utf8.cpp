@@ -0,0 +1,155 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "./utf8.hpp"
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SHIPWRIGHT_UTF8_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+    // Skips the ASCII prefix of [first, last), returning the first non-ASCII byte (or last).
+    unsigned char const* skip_ascii(unsigned char const* first, unsigned char const* last)
+    {
+#ifdef SHIPWRIGHT_UTF8_SSE2
+        // 64 bytes per iteration; a single movemask tells whether any high bit is set
+        while (last - first >= 64) {
+            auto const* p = reinterpret_cast<__m128i const*>(first);
+            auto const any = _mm_or_si128(_mm_or_si128(_mm_loadu_si128(p), _mm_loadu_si128(p + 1)),
+                _mm_or_si128(_mm_loadu_si128(p + 2), _mm_loadu_si128(p + 3)));
+            if (_mm_movemask_epi8(any) != 0) break;
+            first += 64;
+        }
+        while (last - first >= 16) {
+            auto const bytes = _mm_loadu_si128(reinterpret_cast<__m128i const*>(first));
+            if (_mm_movemask_epi8(bytes) != 0) break;
+            first += 16;
+        }
+#else
+        while (last - first >= 8) {
+            std::uint64_t word;
+            std::memcpy(&word, first, sizeof(word));
+            if (word & 0x8080808080808080u) break;
+            first += 8;
+        }
+#endif
+        while (first != last && *first < 0x80) {
+            ++first;
+        }
+        return first;
+    }
+}
+
+namespace shipwright::input {
+    bool utf8_validator::feed(std::string_view chunk)
+    {
+        if (error_offset_) return false;
+
+        auto const* const begin = reinterpret_cast<unsigned char const*>(chunk.data());
+        auto const* const end = begin + chunk.size();
+        auto const* pos = begin;
+
+        auto const fail = [&](std::size_t offset) {
+            error_offset_ = offset;
+            offset_ += chunk.size();
+            return false;
+        };
+
+        while (pos != end) {
+            if (remaining_ == 0) {
+                pos = ::skip_ascii(pos, end);
+                if (pos == end) break;
+
+                // Lead byte; see the Unicode Standard, table 3-7
+                auto const lead = *pos;
+                sequence_start_ = offset_ + static_cast<std::size_t>(pos - begin);
+                lower_ = 0x80;
+                upper_ = 0xBF;
+
+                if (lead >= 0xC2 && lead <= 0xDF) {
+                    remaining_ = 1;
+                } else if (lead >= 0xE0 && lead <= 0xEF) {
+                    remaining_ = 2;
+                    if (lead == 0xE0) lower_ = 0xA0;
+                    if (lead == 0xED) upper_ = 0x9F;
+                } else if (lead >= 0xF0 && lead <= 0xF4) {
+                    remaining_ = 3;
+                    if (lead == 0xF0) lower_ = 0x90;
+                    if (lead == 0xF4) upper_ = 0x8F;
+                } else {
+                    return fail(sequence_start_);
+                }
+                ++pos;
+                continue;
+            }
+
+            auto const byte = *pos;
+            if (byte < lower_ || byte > upper_) {
+                remaining_ = 0;
+                return fail(sequence_start_);
+            }
+
+            lower_ = 0x80;
+            upper_ = 0xBF;
+            --remaining_;
+            ++pos;
+        }
+
+        offset_ += chunk.size();
+        return true;
+    }
+
+    bool utf8_validator::finish()
+    {
+        if (!error_offset_ && remaining_ != 0) {
+            error_offset_ = sequence_start_;
+            remaining_ = 0;
+        }
+        return !error_offset_;
+    }
+
+    std::optional<std::size_t> find_invalid_utf8(std::string_view text)
+    {
+        utf8_validator validator;
+        validator.feed(text);
+        validator.finish();
+
+        return validator.error_offset();
+    }
+
+    byte_order_mark detect_bom(std::string_view text)
+    {
+        using namespace std::literals;
+
+        auto const starts_with = [&](std::string_view prefix) {
+            return text.substr(0, prefix.size()) == prefix;
+        };
+
+        // UTF-32LE's BOM starts with UTF-16LE's, so check it first
+        if (starts_with("\xFF\xFE\0\0"sv)) return byte_order_mark::utf32_le;
+        if (starts_with("\0\0\xFE\xFF"sv)) return byte_order_mark::utf32_be;
+        if (starts_with("\xEF\xBB\xBF"sv)) return byte_order_mark::utf8;
+        if (starts_with("\xFF\xFE"sv)) return byte_order_mark::utf16_le;
+        if (starts_with("\xFE\xFF"sv)) return byte_order_mark::utf16_be;
+        return byte_order_mark::none;
+    }
+
+    std::size_t bom_length(byte_order_mark bom)
+    {
+        switch (bom) {
+        case byte_order_mark::none: return 0;
+        case byte_order_mark::utf8: return 3;
+        case byte_order_mark::utf16_le:
+        case byte_order_mark::utf16_be: return 2;
+        case byte_order_mark::utf32_le:
+        case byte_order_mark::utf32_be: return 4;
+        }
+        return 0;
+    }
+}
@@ -0,0 +1,67 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace shipwright::input {
+    // Validates UTF-8 incrementally, so that text can be checked chunk by chunk as it is read,
+    // while each chunk is still in cache. Sequences may be split across chunks.
+    //
+    // Runs of ASCII, which is nearly all of any CMake file, are skipped with SIMD where
+    // available.
+    class utf8_validator
+    {
+    public:
+        // Returns false once any invalid UTF-8 has been seen.
+        bool feed(std::string_view chunk);
+
+        // Call after the last chunk. Returns false if the text was invalid, including if it
+        // ended partway through a sequence.
+        bool finish();
+
+        // The offset of the first byte of the first invalid sequence, counting from the
+        // start of the first chunk.
+        std::optional<std::size_t> error_offset() const
+        {
+            return error_offset_;
+        }
+
+    private:
+        std::size_t offset_ = 0;
+        // The sequence in progress, if `remaining != 0`
+        std::size_t sequence_start_ = 0;
+        std::uint8_t remaining_ = 0;
+        // The range of the next continuation byte
+        std::uint8_t lower_ = 0x80;
+        std::uint8_t upper_ = 0xBF;
+
+        std::optional<std::size_t> error_offset_;
+    };
+
+    // The offset of the first invalid sequence in `text`, if any.
+    std::optional<std::size_t> find_invalid_utf8(std::string_view text);
+
+    enum class byte_order_mark
+    {
+        none,
+        utf8,
+        utf16_le,
+        utf16_be,
+        utf32_le,
+        utf32_be,
+    };
+
+    // Identifies the byte order mark at the start of `text`. Only a UTF-8 BOM can precede
+    // valid UTF-8; the others identify why the text is not UTF-8.
+    byte_order_mark detect_bom(std::string_view text);
+
+    std::size_t bom_length(byte_order_mark bom);
+}
@@ -0,0 +1,162 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "./utf8.hpp"
+
+#include <shipwright/input/input.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <string_view>
+
+using namespace std::literals;
+namespace input = shipwright::input;
+
+TEST_CASE("Valid UTF-8 is accepted", "[utf8]")
+{
+    auto const text = GENERATE(as<std::string>{},
+        "",
+        "cmake_minimum_required(VERSION 3.12)\n",
+        "\xC2\xA9",
+        "\xE2\x82\xAC",
+        "\xED\x9F\xBF",
+        "\xEF\xBB\xBF",
+        "\xF0\x9F\x98\x80",
+        "\xF4\x8F\xBF\xBF",
+        // Long enough to go through the vectorized paths, with non-ASCII at the end of a block
+        std::string(63, 'a') + "\xC3\xA9" + std::string(100, 'b') + "\xE2\x82\xAC");
+
+    CAPTURE(text);
+
+    CHECK_FALSE(input::find_invalid_utf8(text));
+}
+
+TEST_CASE("Invalid UTF-8 is reported at the start of the bad sequence", "[utf8]")
+{
+    auto [text, offset] = GENERATE(table<std::string, std::size_t>({
+        {"\x80", 0},
+        {"ab\xFF", 2},
+        {"a\xC0\xAF", 1},       // overlong
+        {"a\xC1\xBF", 1},       // overlong
+        {"a\xE0\x80\xAF", 1},   // overlong
+        {"a\xED\xA0\x80", 1},   // surrogate
+        {"a\xF0\x80\x80\xAF", 1}, // overlong
+        {"a\xF4\x90\x80\x80", 1}, // above U+10FFFF
+        {"a\xF5\x80\x80\x80", 1},
+        {"a\xC3" "b", 1},       // missing continuation
+        {"a\xE2\x82", 1},       // truncated at the end
+        {std::string(100, 'a') + "\xFE", 100},
+        {std::string(70, 'a') + "\xC3\xA9" + std::string(70, 'a') + "\xC3", 142},
+    }));
+
+    CAPTURE(text);
+
+    CHECK(input::find_invalid_utf8(text) == offset);
+}
+
+TEST_CASE("Sequences may be split across chunks", "[utf8]")
+{
+    std::string const text = "x\xF0\x9F\x98\x80y\xE2\x82\xAC";
+
+    for (std::size_t split = 0; split <= text.size(); ++split) {
+        CAPTURE(split);
+
+        input::utf8_validator validator;
+        CHECK(validator.feed(std::string_view{text}.substr(0, split)));
+        CHECK(validator.feed(std::string_view{text}.substr(split)));
+        CHECK(validator.finish());
+    }
+
+    input::utf8_validator validator;
+    CHECK(validator.feed("abc\xE2\x82"));
+    CHECK_FALSE(validator.feed("x"));
+    CHECK(validator.error_offset() == 3u);
+}
+
+TEST_CASE("Byte order marks are identified", "[utf8]")
+{
+    CHECK(input::detect_bom("abc") == input::byte_order_mark::none);
+    CHECK(input::detect_bom("\xEF\xBB\xBF" "abc") == input::byte_order_mark::utf8);
+    CHECK(input::detect_bom("\xFF\xFE" "a\0"sv) == input::byte_order_mark::utf16_le);
+    CHECK(input::detect_bom("\xFE\xFF\0a"sv) == input::byte_order_mark::utf16_be);
+    CHECK(input::detect_bom("\xFF\xFE\0\0"sv) == input::byte_order_mark::utf32_le);
+    CHECK(input::detect_bom("\0\0\xFE\xFF"sv) == input::byte_order_mark::utf32_be);
+}
+
+TEST_CASE("Loading strips a UTF-8 BOM and validates the rest", "[utf8]")
+{
+    auto const load = [](std::string_view contents, input::load_options options = {}) {
+        auto* file = std::tmpfile();
+        REQUIRE(file);
+        std::fwrite(contents.data(), 1, contents.size(), file);
+        std::rewind(file);
+
+        auto result = input::load(file, options);
+        std::fclose(file);
+
+        REQUIRE(result);
+        return *std::move(result);
+    };
+
+    auto const with_bom = load("\xEF\xBB\xBFproject(x)\n");
+    CHECK(with_bom.bom == input::byte_order_mark::utf8);
+    CHECK(with_bom.text == "project(x)\n");
+    CHECK_FALSE(with_bom.invalid_utf8_offset);
+
+    input::load_options keep_bom;
+    keep_bom.strip_utf8_bom = false;
+    auto const kept = load("\xEF\xBB\xBFproject(x)\n", keep_bom);
+    CHECK(kept.bom == input::byte_order_mark::utf8);
+    CHECK(kept.text == "\xEF\xBB\xBFproject(x)\n");
+    CHECK_FALSE(kept.invalid_utf8_offset);
+
+    auto const invalid = load("\xEF\xBB\xBFproject(\xFF)\n");
+    CHECK(invalid.invalid_utf8_offset == 8u);
+
+    auto const utf16 = load("\xFF\xFEp\0"sv);
+    CHECK(utf16.bom == input::byte_order_mark::utf16_le);
+    CHECK(utf16.invalid_utf8_offset == 0u);
+
+    std::string const large(200 * 1024, 'a');
+    auto const big = load(large + "\xC3");
+    CHECK(big.text.size() == large.size() + 1);
+    CHECK(big.invalid_utf8_offset == large.size());
+}
+
+TEST_CASE("Loading stops once the input is known to be too large", "[utf8]")
+{
+    std::string const contents(200 * 1024, 'a');
+
+    auto* file = std::tmpfile();
+    REQUIRE(file);
+    std::fwrite(contents.data(), 1, contents.size(), file);
+
+    auto const load = [&](std::size_t max_bytes) {
+        std::rewind(file);
+
+        input::load_options options;
+        options.max_bytes = max_bytes;
+        auto result = input::load(file, options);
+
+        REQUIRE(result);
+        return *std::move(result);
+    };
+
+    auto const fits = load(contents.size());
+    CHECK_FALSE(fits.too_large);
+    CHECK(fits.text == contents);
+
+    auto const too_large = load(contents.size() / 2);
+    CHECK(too_large.too_large);
+    CHECK(too_large.text.empty());
+    // Only one byte more than the limit was read
+    CHECK(std::ftell(file) == static_cast<long>(contents.size() / 2 + 1));
+
+    std::fclose(file);
+}
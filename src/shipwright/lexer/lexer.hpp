@@ -10,6 +10,8 @@
 #include <string_view>
 
 #include <shipwright/debug_print.hpp>
+#include <shipwright/error.hpp>
+#include <shipwright/limits.hpp>
 #include <shipwright/token.hpp>
 
 namespace shipwright {
@@ -21,7 +23,10 @@ namespace shipwright {
         class sentinel
         {};
 
-        explicit lexer(std::string_view text);
+        // Lexing stops early, as though the input had ended, if `limits` are exceeded.
+        // Only the byte and token limits apply to the lexer. Skipped trivia isn't counted.
+        explicit lexer(std::string_view text, shipwright::limits const& limits = {},
+            trivia mode = trivia::keep);
         lexer(lexer const&) = delete;
         ~lexer();
 
@@ -30,6 +35,12 @@ namespace shipwright {
         iterator end() const;
         sentinel end_sentinel() const;
 
+        // Why lexing stopped early, if it did
+        std::optional<parse_error> const& error() const
+        {
+            return error_;
+        }
+
     private:
         // lexer-generator functions
         void advance();
@@ -37,10 +48,16 @@ namespace shipwright {
         token const& read() const;
         // end of lexer-generator functions
 
+        void fail(error_kind kind, std::size_t offset, char const* message);
+
         void* lexer_ = nullptr;
         std::optional<token> current_token_ = {};
 
         std::string_view input_;
+
+        shipwright::limits limits_;
+        std::size_t token_count_ = 0;
+        std::optional<parse_error> error_ = {};
     };
 
     std::ostream& operator<<(std::ostream& out, debug_print<lexer::sentinel> const& sentinel);
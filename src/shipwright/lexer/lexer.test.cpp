@@ -296,3 +296,54 @@ TEST_CASE("Can parse legacy unquoted arguments", "[lexer]")
     std::vector<token> result{lex.begin(), lex.end()};
     CHECK(result == std::vector<token>{expected});
 }
+
+TEST_CASE("Can skip trivia", "[lexer]")
+{
+    std::string const input = "add_library(a # comment\n"
+                              "    #[[bracket\ncomment]] b)  # trailing\n"
+                              "\n"
+                              "#[[file-level]]\n";
+
+    lexer lex{input, {}, shipwright::trivia::skip};
+
+    std::vector<token> result{lex.begin(), lex.end()};
+
+    CHECK(result
+        == std::vector<token>{
+            token{"add_library", token_type::identifier, "add_library"},
+            token{"", token_type::lparen, "("},
+            token{"a", token_type::identifier, "a"},
+            token{"b", token_type::identifier, "b"},
+            token{"", token_type::rparen, ")"},
+            token{"", token_type::newline, "\n"},
+            token{"", token_type::newline, "\n"},
+            token{"", token_type::newline, "\n"},
+        });
+}
+
+TEST_CASE("Overlong tokens stop the lexer where they start", "[lexer]")
+{
+    std::string lines;
+    for (int i = 0; i < 1000; ++i) {
+        lines += "line\n";
+    }
+
+    auto const input = GENERATE_COPY(
+        "a [[" + lines + "]]\n", "a [[" + lines, "a \"" + lines + "\"\n", "a \"" + lines);
+    CAPTURE(input.substr(0, 8));
+
+    shipwright::limits limits;
+    limits.max_token_bytes = 16;
+    lexer lex{input, limits};
+
+    std::vector<token> result{lex.begin(), lex.end()};
+    CHECK(result
+        == std::vector<token>{
+            token{"a", token_type::identifier, "a"},
+            token{" ", token_type::space, " "},
+        });
+
+    REQUIRE(lex.error());
+    CHECK(lex.error()->kind == shipwright::error_kind::token_too_long);
+    CHECK(lex.error()->offset == 2);
+}
@@ -0,0 +1,140 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "./parallel.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <numeric>
+#include <thread>
+
+#include <shipwright/lexer/lexer.hpp>
+#include <shipwright/parallel.hpp>
+
+namespace {
+    struct chunk
+    {
+        std::size_t first;
+        std::size_t last;
+        // As lexed speculatively, assuming that `first` is between two tokens
+        std::vector<shipwright::token> tokens;
+    };
+
+    // Chunks end just after a newline. A newline only continues a token inside a
+    // quoted or bracket argument (or comment), which the repair step relies upon.
+    std::vector<chunk> split(std::string_view input, std::size_t chunk_size)
+    {
+        std::vector<chunk> chunks;
+
+        for (std::size_t first = 0; first < input.size();) {
+            auto last = input.size();
+            if (input.size() - first > chunk_size) {
+                auto const newline = input.find('\n', first + chunk_size - 1);
+                if (newline != std::string_view::npos) last = newline + 1;
+            }
+
+            chunks.push_back(chunk{first, last, {}});
+            first = last;
+        }
+
+        return chunks;
+    }
+
+    std::size_t end_offset(std::string_view input, shipwright::token const& token)
+    {
+        return static_cast<std::size_t>(token.full_text.data() - input.data())
+            + token.full_text.size();
+    }
+}
+
+namespace shipwright {
+    std::vector<token> lex_parallel(std::string_view input, parallel_lex_options const& options)
+    {
+        auto const threads = options.threads != 0
+            ? options.threads
+            : std::max(1u, std::thread::hardware_concurrency());
+        // A few chunks per thread evens out chunks which are slower to lex than others
+        auto const chunk_size
+            = std::max({options.min_chunk_bytes, input.size() / (threads * 4), std::size_t{1}});
+
+        auto chunks = ::split(input, chunk_size);
+
+        shipwright::parallel_for(chunks.size(), threads, [&](std::size_t i) {
+            auto& chunk = chunks[i];
+
+            shipwright::lexer lex{input.substr(chunk.first, chunk.last - chunk.first)};
+            for (auto const& token : lex) {
+                chunk.tokens.push_back(token);
+            }
+        });
+
+        std::vector<token> result;
+        result.reserve(std::accumulate(chunks.begin(), chunks.end(), std::size_t{0},
+            [](std::size_t sum, auto const& chunk) { return sum + chunk.tokens.size(); }));
+
+        // Where the next token starts, which is always between tokens
+        std::size_t position = 0;
+
+        for (std::size_t i = 0; i < chunks.size();) {
+            auto& chunk = chunks[i];
+            assert(chunk.first == position);
+
+            // Speculation started in the right place, so the tokens agree with the serial
+            // lexer's, except that the last one may have been cut short by the end of the
+            // chunk. Were it a newline, it would be complete.
+            bool const complete = i + 1 == chunks.size()
+                || (!chunk.tokens.empty() && chunk.tokens.back().type == token_type::newline);
+            auto const accepted = chunk.tokens.size() - (complete || chunk.tokens.empty() ? 0 : 1);
+
+            result.insert(result.end(), chunk.tokens.begin(),
+                chunk.tokens.begin() + static_cast<std::ptrdiff_t>(accepted));
+            if (accepted != 0) position = ::end_offset(input, result.back());
+
+            chunk.tokens = {};
+            if (complete) {
+                ++i;
+                continue;
+            }
+
+            // Lex serially until a token ends exactly where a later chunk begins, from
+            // which point that chunk's tokens are trustworthy again.
+            //
+            // The lexer copies its input, so it's given a window of the input rather than
+            // all that remains. The window ends at a chunk boundary, and so just after a
+            // newline: only an unterminated quoted or bracket argument can reach past it.
+            // When one does, the window doubles and lexing resumes from that argument.
+            for (std::size_t window_chunks = 2;; window_chunks *= 2) {
+                auto const window_end = std::min(i + window_chunks, chunks.size());
+                auto const window_last = chunks[window_end - 1].last;
+                bool const window_ends_input = window_last == input.size();
+
+                shipwright::lexer lex{input.substr(position, window_last - position)};
+                bool cut_short = false;
+                for (auto const& token : lex) {
+                    if (!window_ends_input
+                        && (token.type == token_type::unterminated_quote
+                            || token.type == token_type::unterminated_bracket)) {
+                        cut_short = true;
+                        break;
+                    }
+
+                    result.push_back(token);
+                    position = ::end_offset(input, token);
+
+                    while (i < chunks.size() && chunks[i].first < position) {
+                        chunks[i].tokens = {};
+                        ++i;
+                    }
+                    if (i < chunks.size() && chunks[i].first == position) break;
+                }
+                if (!cut_short) break;
+            }
+        }
+
+        return result;
+    }
+}
@@ -0,0 +1,34 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+#include <shipwright/token.hpp>
+
+namespace shipwright {
+    struct parallel_lex_options
+    {
+        // 0 means one per hardware thread
+        unsigned threads = 0;
+        // Chunks are at least this large, so small inputs are lexed on one thread
+        std::size_t min_chunk_bytes = 1024 * 1024;
+    };
+
+    // Lexes `input` as `shipwright::lexer` would, producing the same tokens, but splits
+    // the input into chunks which are lexed concurrently.
+    //
+    // Each chunk is lexed assuming it begins between tokens. Wherever that turns out to
+    // be wrong, such as when a chunk begins inside a quoted argument, the affected
+    // stretch is lexed again serially, in windows which double until a token ends on a
+    // chunk boundary. An input which is one huge bracket argument therefore costs
+    // roughly three times as much as lexing it serially.
+    std::vector<token> lex_parallel(
+        std::string_view input, parallel_lex_options const& options = {});
+}
@@ -0,0 +1,103 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "./parallel.hpp"
+
+#include <shipwright/lexer/lexer.hpp>
+#include <shipwright/token.test.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <string>
+#include <vector>
+
+using shipwright::lex_parallel;
+using shipwright::lexer;
+using shipwright::parallel_lex_options;
+using shipwright::token;
+
+namespace {
+    std::vector<token> lex_serial(std::string_view input)
+    {
+        lexer lex{input};
+        return std::vector<token>(lex.begin(), lex.end());
+    }
+
+    // `token`'s equality ignores `full_text`, but the tokens must also be the same spans
+    bool same_spans(std::vector<token> const& lhs, std::vector<token> const& rhs)
+    {
+        if (lhs.size() != rhs.size()) return false;
+
+        for (std::size_t i = 0; i < lhs.size(); ++i) {
+            if (lhs[i].full_text.data() != rhs[i].full_text.data()
+                || lhs[i].full_text.size() != rhs[i].full_text.size()) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+TEST_CASE("Parallel lexing matches serial lexing", "[lexer][parallel]")
+{
+    std::string const input = GENERATE(as<std::string>{},
+        "",
+        "project(x)\n",
+        "project(x)",
+        "set(A \"a quoted\nargument\nspanning lines\")\nmessage(${A})\n",
+        "set(A [[a bracket\nargument\n\nspanning lines]])\n# comment\nmessage(${A})\n",
+        "# comment (\n# \"more\n\n\nadd_library(a b c)\n",
+        "message(\"unterminated\nquote\n",
+        "message([[unterminated\nbracket\n",
+        "\n\n\n\n");
+
+    auto const chunk_size = GENERATE(std::size_t{1}, 2, 3, 5, 8, 1024);
+    auto const threads = GENERATE(1u, 4u);
+
+    CAPTURE(input, chunk_size, threads);
+
+    auto const expected = ::lex_serial(input);
+    auto const result = lex_parallel(input, parallel_lex_options{threads, chunk_size});
+
+    CHECK(result == expected);
+    CHECK(::same_spans(result, expected));
+}
+
+TEST_CASE("Parallel lexing handles many chunks", "[lexer][parallel]")
+{
+    std::string input;
+    for (int i = 0; i < 1000; ++i) {
+        input += "add_library(target" + std::to_string(i) + " \"a\nb\" [[c\n]])\n";
+    }
+
+    auto const expected = ::lex_serial(input);
+    auto const result = lex_parallel(input, parallel_lex_options{0, 64});
+
+    CHECK(result == expected);
+    CHECK(::same_spans(result, expected));
+}
+
+TEST_CASE("Parallel lexing repairs arguments spanning many chunks", "[lexer][parallel]")
+{
+    std::string lines;
+    for (int i = 0; i < 100; ++i) {
+        lines += "line " + std::to_string(i) + "\n";
+    }
+
+    std::string const input = GENERATE_COPY(as<std::string>{},
+        "set(A [[" + lines + "]])\nset(B \"" + lines + "\")\nmessage(${A})\n",
+        "message([[" + lines,
+        "message(\"" + lines);
+    auto const chunk_size = GENERATE(std::size_t{1}, 8, 100);
+
+    CAPTURE(chunk_size);
+
+    auto const expected = ::lex_serial(input);
+    auto const result = lex_parallel(input, parallel_lex_options{4, chunk_size});
+
+    CHECK(result == expected);
+    CHECK(::same_spans(result, expected));
+}
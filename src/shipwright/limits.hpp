@@ -0,0 +1,32 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <limits>
+
+namespace shipwright {
+    // Bounds on the work and memory which lexing and parsing a single input may take.
+    // Exceeding any of them aborts with an error as soon as it is noticed.
+    struct limits
+    {
+        static constexpr std::size_t unlimited = std::numeric_limits<std::size_t>::max();
+
+        // Size of the whole input
+        std::size_t max_bytes = unlimited;
+        std::size_t max_tokens = unlimited;
+        // Size of any one token, such as a bracket argument. Checked while the token is
+        // scanned, a line at a time, so an overlong token isn't scanned to its end.
+        std::size_t max_token_bytes = unlimited;
+        // How deeply parentheses may nest, counting those of the command invocation itself
+        std::size_t max_nesting_depth = unlimited;
+        // Arguments, file elements and bracket comments in the AST
+        std::size_t max_ast_nodes = unlimited;
+        // Memory taken by those nodes. Approximate: doesn't count spare vector capacity.
+        std::size_t max_ast_bytes = unlimited;
+    };
+}
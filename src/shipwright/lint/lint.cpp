@@ -0,0 +1,16 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "./lint.hpp"
+
+#include <shipwright/strings.hpp>
+
+namespace shipwright::lint {
+    bool command_matches(std::string_view command_id, std::string_view name)
+    {
+        return shipwright::iequals(command_id, name);
+    }
+}
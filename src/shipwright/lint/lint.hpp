@@ -0,0 +1,342 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <shipwright/ast/ast.hpp>
+#include <shipwright/parallel.hpp>
+#include <shipwright/strings.hpp>
+
+namespace shipwright::lint {
+    struct diagnostic
+    {
+        std::string_view rule;
+        // Refers into the linted text
+        std::string_view span;
+        std::string message;
+    };
+
+    struct input
+    {
+        std::string_view path;
+        std::string_view text;
+        ast::file const* file;
+    };
+
+    class context
+    {
+    public:
+        context(input const& in, std::vector<diagnostic>& out)
+            : input_{in}
+            , out_{out}
+        {}
+
+        std::string_view path() const
+        {
+            return input_.path;
+        }
+
+        std::string_view text() const
+        {
+            return input_.text;
+        }
+
+        // The innermost command invocation being visited, if any
+        ast::command_invocation const* command() const
+        {
+            return command_;
+        }
+
+        void report(std::string_view span, std::string message)
+        {
+            out_.push_back(diagnostic{rule_, span, std::move(message)});
+        }
+
+    private:
+        template <typename... Rules>
+        friend class engine;
+
+        input const& input_;
+        std::vector<diagnostic>& out_;
+        std::string_view rule_;
+        ast::command_invocation const* command_ = nullptr;
+    };
+
+    // Case-insensitive, as command names are to CMake.
+    bool command_matches(std::string_view command_id, std::string_view name);
+
+    namespace detail {
+        template <typename Rule, typename Node, typename = void>
+        struct visits : std::false_type
+        {};
+
+        template <typename Rule, typename Node>
+        struct visits<Rule, Node,
+            std::void_t<decltype(
+                std::declval<Rule const&>().visit(std::declval<Node const&>(), std::declval<context&>()))>>
+            : std::true_type
+        {};
+
+        template <typename Rule, typename = void>
+        struct has_command_filter : std::false_type
+        {};
+
+        template <typename Rule>
+        struct has_command_filter<Rule, std::void_t<decltype(Rule::commands)>> : std::true_type
+        {};
+    }
+
+    // Runs a fixed set of rules over files, visiting each node of each file once no matter how
+    // many rules there are.
+    //
+    // A rule is a type with a `static constexpr std::string_view name` and `visit` overloads for
+    // whichever node types it wants to see:
+    //
+    //     void visit(ast::command_invocation const&, lint::context&) const;
+    //     void visit(ast::unquoted_argument const&, lint::context&) const;
+    //
+    // Any of `command_invocation`, `bracket_argument`, `quoted_argument`, `unquoted_argument`,
+    // `parenthesized_argument`, `line_comment` and `bracket_comment` may be visited. Which rules
+    // see which nodes is decided at compile time; node types no rule visits aren't walked at all.
+    //
+    // A rule may also declare `static constexpr std::string_view commands[]`, in which case it is
+    // only shown command invocations with those names and their arguments.
+    //
+    // Files are linted in parallel, so `visit` must be safe to call concurrently.
+    template <typename... Rules>
+    class engine
+    {
+    public:
+        explicit engine(Rules... rules)
+            : rules_{std::move(rules)...}
+        {}
+
+        std::vector<diagnostic> run(input const& in) const
+        {
+            std::vector<diagnostic> result;
+            context ctx{in, result};
+
+            for (auto const& element : in.file->elements) {
+                walk_element(element, ctx);
+            }
+
+            return result;
+        }
+
+        // Results are in the same order as `inputs`.
+        // A `threads` of 0 means one per hardware thread.
+        std::vector<std::vector<diagnostic>> run(
+            std::vector<input> const& inputs, unsigned threads = 0) const
+        {
+            std::vector<std::vector<diagnostic>> results(inputs.size());
+
+            shipwright::parallel_for(inputs.size(), threads,
+                [&](std::size_t i) { results[i] = run(inputs[i]); });
+
+            return results;
+        }
+
+    private:
+        static constexpr std::size_t rule_count = sizeof...(Rules);
+        using active_set = std::array<bool, rule_count>;
+        using rule_tuple = std::tuple<Rules...>;
+
+        template <typename Node>
+        static constexpr bool any_visits = (detail::visits<Rules, Node>::value || ...);
+
+        static constexpr bool any_visits_arguments = any_visits<ast::bracket_argument>
+            || any_visits<ast::quoted_argument> || any_visits<ast::unquoted_argument>
+            || any_visits<ast::parenthesized_argument> || any_visits<ast::line_comment>
+            || any_visits<ast::bracket_comment>;
+
+        static constexpr bool any_filtered = (detail::has_command_filter<Rules>::value || ...);
+
+        void walk_element(ast::file_element const& element, context& ctx) const
+        {
+            constexpr active_set all = make_all_active();
+
+            if (auto const* command = std::get_if<ast::command_invocation>(&element.value)) {
+                walk_command(*command, ctx);
+            } else if constexpr (any_visits<ast::bracket_comment>) {
+                for (auto const& comment : std::get<std::vector<ast::bracket_comment>>(element.value)) {
+                    dispatch_unfiltered(comment, all, ctx);
+                }
+            }
+
+            if constexpr (any_visits<ast::line_comment>) {
+                if (element.comment) dispatch_unfiltered(*element.comment, all, ctx);
+            }
+        }
+
+        void walk_command(ast::command_invocation const& command, context& ctx) const
+        {
+            active_set active = make_all_active();
+            if constexpr (any_filtered) active = make_active(command.command_id.value);
+
+            ctx.command_ = &command;
+            if constexpr (any_visits<ast::command_invocation>) dispatch(command, active, ctx);
+            if constexpr (any_visits_arguments) walk_arguments(command.arguments, active, ctx);
+            ctx.command_ = nullptr;
+        }
+
+        void walk_arguments(std::vector<ast::argument> const& arguments, active_set const& active,
+            context& ctx) const
+        {
+            for (auto const& argument : arguments) {
+                std::visit(
+                    [&](auto const& node) {
+                        using node_type = std::decay_t<decltype(node)>;
+
+                        if constexpr (any_visits<node_type>) dispatch(node, active, ctx);
+
+                        if constexpr (std::is_same_v<node_type, ast::parenthesized_argument>) {
+                            walk_arguments(node.values, active, ctx);
+                        }
+                    },
+                    argument.value);
+            }
+        }
+
+        // Outside of any command, only rules without a command filter are interested
+        template <typename Node>
+        void dispatch_unfiltered(Node const& node, active_set const& all, context& ctx) const
+        {
+            dispatch_unfiltered_impl(node, all, ctx, std::index_sequence_for<Rules...>{});
+        }
+
+        template <typename Node, std::size_t... I>
+        void dispatch_unfiltered_impl(
+            Node const& node, active_set const& all, context& ctx, std::index_sequence<I...>) const
+        {
+            (visit_one<I>(node, all, ctx,
+                 std::bool_constant<!detail::has_command_filter<Rules>::value>{}),
+                ...);
+        }
+
+        template <typename Node>
+        void dispatch(Node const& node, active_set const& active, context& ctx) const
+        {
+            dispatch_impl(node, active, ctx, std::index_sequence_for<Rules...>{});
+        }
+
+        template <typename Node, std::size_t... I>
+        void dispatch_impl(
+            Node const& node, active_set const& active, context& ctx, std::index_sequence<I...>) const
+        {
+            (visit_one<I>(node, active, ctx, std::true_type{}), ...);
+        }
+
+        template <std::size_t I, typename Node, bool Allowed>
+        void visit_one(Node const& node, active_set const& active, context& ctx,
+            std::bool_constant<Allowed>) const
+        {
+            using rule = std::tuple_element_t<I, rule_tuple>;
+
+            if constexpr (Allowed && detail::visits<rule, Node>::value) {
+                if (active[I]) {
+                    ctx.rule_ = rule::name;
+                    std::get<I>(rules_).visit(node, ctx);
+                }
+            }
+        }
+
+        struct command_filters
+        {
+            // Which rules are interested in each command some rule names, sorted
+            // case-insensitively by name with one entry per name
+            std::vector<std::pair<std::string_view, active_set>> by_name;
+            // Which rules are interested in any other command
+            active_set unfiltered;
+        };
+
+        static active_set make_active(std::string_view command_id)
+        {
+            auto const& filters = engine::filters();
+            auto const found = std::lower_bound(filters.by_name.begin(), filters.by_name.end(),
+                command_id, [](auto const& entry, std::string_view id) {
+                    return shipwright::iless(entry.first, id);
+                });
+
+            if (found != filters.by_name.end() && shipwright::iequals(found->first, command_id)) {
+                return found->second;
+            }
+            return filters.unfiltered;
+        }
+
+        // Built on first use, so that finding the rules for a command is one binary search
+        // rather than a comparison with every name every rule lists
+        static command_filters const& filters()
+        {
+            static command_filters const filters
+                = make_command_filters(std::index_sequence_for<Rules...>{});
+            return filters;
+        }
+
+        template <std::size_t... I>
+        static command_filters make_command_filters(std::index_sequence<I...>)
+        {
+            command_filters filters{{}, {!detail::has_command_filter<Rules>::value...}};
+            (add_command_filter<I>(filters), ...);
+
+            auto& by_name = filters.by_name;
+            std::sort(by_name.begin(), by_name.end(), [](auto const& lhs, auto const& rhs) {
+                return shipwright::iless(lhs.first, rhs.first);
+            });
+
+            // Merge the entries of any name listed more than once
+            std::size_t kept = 0;
+            for (std::size_t i = 0; i < by_name.size(); ++i) {
+                if (kept != 0 && shipwright::iequals(by_name[kept - 1].first, by_name[i].first)) {
+                    for (std::size_t rule = 0; rule < rule_count; ++rule) {
+                        auto& active = by_name[kept - 1].second[rule];
+                        active = active || by_name[i].second[rule];
+                    }
+                } else {
+                    by_name[kept++] = by_name[i];
+                }
+            }
+            by_name.resize(kept);
+
+            return filters;
+        }
+
+        template <std::size_t I>
+        static void add_command_filter(command_filters& filters)
+        {
+            using rule = std::tuple_element_t<I, rule_tuple>;
+
+            if constexpr (detail::has_command_filter<rule>::value) {
+                for (std::string_view name : rule::commands) {
+                    auto active = filters.unfiltered;
+                    active[I] = true;
+                    filters.by_name.emplace_back(name, active);
+                }
+            }
+        }
+
+        static constexpr active_set make_all_active()
+        {
+            active_set all{};
+            for (auto& active : all) {
+                active = true;
+            }
+            return all;
+        }
+
+        rule_tuple rules_;
+    };
+}
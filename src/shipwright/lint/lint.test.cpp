@@ -0,0 +1,209 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "./lint.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ast = shipwright::ast;
+namespace lint = shipwright::lint;
+
+namespace {
+    struct uppercase_command
+    {
+        static constexpr std::string_view name = "uppercase-command";
+
+        void visit(ast::command_invocation const& command, lint::context& ctx) const
+        {
+            auto const id = command.command_id.value;
+            if (id.find_first_of("ABCDEFGHIJKLMNOPQRSTUVWXYZ") != std::string_view::npos) {
+                ctx.report(id, "command names should be lowercase");
+            }
+        }
+    };
+
+    struct set_cache
+    {
+        static constexpr std::string_view name = "set-cache";
+        static constexpr std::string_view commands[] = {"set"};
+
+        void visit(ast::unquoted_argument const& argument, lint::context& ctx) const
+        {
+            if (argument.value == "CACHE") ctx.report(argument.value, "prefer option()");
+        }
+    };
+
+    struct todo_comment
+    {
+        static constexpr std::string_view name = "todo-comment";
+
+        void visit(ast::line_comment const& comment, lint::context& ctx) const
+        {
+            if (comment.value.find("TODO") != std::string_view::npos) {
+                ctx.report(comment.value, "unresolved TODO");
+            }
+        }
+    };
+
+    // Logs every node it is shown, prefixed with `Id`, to check the order rules run in
+    template <char Id>
+    struct recorder
+    {
+        static constexpr std::string_view name = "recorder";
+
+        std::vector<std::string>* log;
+
+        void visit(ast::command_invocation const& command, lint::context&) const
+        {
+            log->push_back(std::string{Id} + ':' + std::string{command.command_id.value});
+        }
+
+        void visit(ast::unquoted_argument const& argument, lint::context&) const
+        {
+            log->push_back(std::string{Id} + ':' + std::string{argument.value});
+        }
+    };
+
+    struct set_recorder : recorder<'s'>
+    {
+        static constexpr std::string_view commands[] = {"SET", "message"};
+    };
+
+    struct unset_recorder : recorder<'u'>
+    {
+        static constexpr std::string_view commands[] = {"unset", "set"};
+    };
+
+    ast::argument unquoted(std::string_view value)
+    {
+        return ast::argument{ast::unquoted_argument{value}};
+    }
+
+    ast::file_element command(std::string_view id, std::vector<ast::argument> arguments,
+        std::optional<ast::line_comment> comment = std::nullopt)
+    {
+        return ast::file_element{
+            ast::command_invocation{ast::identifier{id}, std::move(arguments)},
+            comment,
+        };
+    }
+
+    std::vector<std::string_view> rules_of(std::vector<lint::diagnostic> const& diagnostics)
+    {
+        std::vector<std::string_view> result;
+        for (auto const& diagnostic : diagnostics) {
+            result.push_back(diagnostic.rule);
+        }
+        return result;
+    }
+}
+
+TEST_CASE("Each rule sees the nodes it visits", "[lint]")
+{
+    ast::file const file{{
+        command("SET", {unquoted("x"), unquoted("1"), unquoted("CACHE"), unquoted("STRING")}),
+        command("message",
+            {
+                unquoted("CACHE"),
+                ast::argument{ast::parenthesized_argument{{unquoted("CACHE")}}},
+            },
+            ast::line_comment{" TODO: remove"}),
+        command("set", {unquoted("y"), ast::argument{ast::parenthesized_argument{{unquoted("CACHE")}}}}),
+    }};
+
+    lint::engine const engine{uppercase_command{}, set_cache{}, todo_comment{}};
+    auto const diagnostics = engine.run(lint::input{"CMakeLists.txt", "", &file});
+
+    CHECK(rules_of(diagnostics)
+        == std::vector<std::string_view>{
+            "uppercase-command",
+            "set-cache",
+            "todo-comment",
+            "set-cache",
+        });
+}
+
+TEST_CASE("All rules run in a single traversal", "[lint]")
+{
+    ast::file const file{{
+        command("foo",
+            {
+                unquoted("x"),
+                ast::argument{ast::parenthesized_argument{{unquoted("y")}}},
+            }),
+        command("bar", {unquoted("z")}),
+    }};
+
+    std::vector<std::string> log;
+    lint::engine const engine{recorder<'a'>{&log}, recorder<'b'>{&log}};
+    engine.run(lint::input{"CMakeLists.txt", "", &file});
+
+    // Separate traversals would show one rule every node before the other saw any
+    CHECK(log
+        == std::vector<std::string>{
+            "a:foo", "b:foo", "a:x", "b:x", "a:y", "b:y", "a:bar", "b:bar", "a:z", "b:z"});
+}
+
+TEST_CASE("Rules are shown only the commands they filter on", "[lint]")
+{
+    ast::file const file{{
+        command("set", {unquoted("1")}),
+        command("Message", {unquoted("2")}),
+        command("UNSET", {unquoted("3")}),
+        command("project", {unquoted("4")}),
+    }};
+
+    std::vector<std::string> log;
+    lint::engine const engine{
+        set_recorder{{&log}}, recorder<'a'>{&log}, unset_recorder{{&log}}};
+    engine.run(lint::input{"CMakeLists.txt", "", &file});
+
+    CHECK(log
+        == std::vector<std::string>{
+            "s:set", "a:set", "u:set", "s:1", "a:1", "u:1",
+            "s:Message", "a:Message", "s:2", "a:2",
+            "a:UNSET", "u:UNSET", "a:3", "u:3",
+            "a:project", "a:4",
+        });
+}
+
+TEST_CASE("Command filters are case-insensitive", "[lint]")
+{
+    CHECK(lint::command_matches("set", "set"));
+    CHECK(lint::command_matches("SET", "set"));
+    CHECK(lint::command_matches("Set", "sEt"));
+    CHECK_FALSE(lint::command_matches("set", "unset"));
+}
+
+TEST_CASE("Files are linted in parallel", "[lint]")
+{
+    std::vector<ast::file> files;
+    for (int i = 0; i < 64; ++i) {
+        ast::file file;
+        for (int j = 0; j < i % 4; ++j) {
+            file.elements.push_back(command("Project", {}));
+        }
+        files.push_back(std::move(file));
+    }
+
+    std::vector<lint::input> inputs;
+    for (auto const& file : files) {
+        inputs.push_back(lint::input{"", "", &file});
+    }
+
+    lint::engine const engine{uppercase_command{}};
+    auto const results = engine.run(inputs, 4);
+
+    REQUIRE(results.size() == files.size());
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        CAPTURE(i);
+        CHECK(results[i].size() == i % 4);
+    }
+}
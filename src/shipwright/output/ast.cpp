@@ -0,0 +1,120 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "./ast.hpp"
+
+#include <cstdint>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#include <shipwright/output/tokens.hpp>
+
+namespace {
+    using shipwright::output::buffered_writer;
+    namespace ast = shipwright::ast;
+
+    // Writes the members every argument and comment has, leaving the object open
+    void open_node(
+        buffered_writer& out, std::string_view type, std::string_view text, std::string_view input)
+    {
+        out.write("{\"type\":\"");
+        out.write(type);
+        out.write("\",\"offset\":");
+        out.write_decimal(shipwright::output::offset_of(text, input));
+        out.write(",\"text\":");
+        shipwright::output::write_json_string(out, text);
+    }
+
+    void write_bracket(buffered_writer& out, std::string_view type,
+        ast::bracket_argument const& bracket, std::string_view input)
+    {
+        ::open_node(out, type, bracket.value, input);
+        out.write(",\"bracket_strength\":");
+        out.write_decimal(static_cast<std::uint64_t>(bracket.bracket_strength));
+        out.put('}');
+    }
+
+    void write_line_comment(
+        buffered_writer& out, ast::line_comment const& comment, std::string_view input)
+    {
+        ::open_node(out, "line_comment", comment.value, input);
+        out.put('}');
+    }
+
+    void write_arguments(
+        buffered_writer& out, std::vector<ast::argument> const& arguments, std::string_view input);
+
+    void write_argument(buffered_writer& out, ast::argument const& argument, std::string_view input)
+    {
+        std::visit(
+            [&](auto const& value) {
+                using type = std::decay_t<decltype(value)>;
+
+                if constexpr (std::is_same_v<type, ast::bracket_argument>) {
+                    ::write_bracket(out, "bracket_argument", value, input);
+                } else if constexpr (std::is_same_v<type, ast::quoted_argument>) {
+                    ::open_node(out, "quoted_argument", value.value, input);
+                    out.put('}');
+                } else if constexpr (std::is_same_v<type, ast::unquoted_argument>) {
+                    ::open_node(out, "unquoted_argument", value.value, input);
+                    out.put('}');
+                } else if constexpr (std::is_same_v<type, ast::parenthesized_argument>) {
+                    out.write("{\"type\":\"parenthesized_argument\",\"arguments\":");
+                    ::write_arguments(out, value.values, input);
+                    out.put('}');
+                } else if constexpr (std::is_same_v<type, ast::line_comment>) {
+                    ::write_line_comment(out, value, input);
+                } else {
+                    static_assert(std::is_same_v<type, ast::bracket_comment>);
+                    ::write_bracket(out, "bracket_comment", value.value, input);
+                }
+            },
+            argument.value);
+    }
+
+    void write_arguments(
+        buffered_writer& out, std::vector<ast::argument> const& arguments, std::string_view input)
+    {
+        out.put('[');
+        for (std::size_t i = 0; i < arguments.size(); ++i) {
+            if (i != 0) out.put(',');
+            ::write_argument(out, arguments[i], input);
+        }
+        out.put(']');
+    }
+}
+
+namespace shipwright::output {
+    void write_ast_json_lines(buffered_writer& out, ast::file const& file, std::string_view input)
+    {
+        for (auto const& element : file.elements) {
+            if (auto const* command = std::get_if<ast::command_invocation>(&element.value)) {
+                out.write("{\"type\":\"command_invocation\",\"offset\":");
+                out.write_decimal(output::offset_of(command->command_id.value, input));
+                out.write(",\"command\":");
+                output::write_json_string(out, command->command_id.value);
+                out.write(",\"arguments\":");
+                ::write_arguments(out, command->arguments, input);
+            } else {
+                auto const& comments = std::get<std::vector<ast::bracket_comment>>(element.value);
+
+                out.write("{\"type\":\"comments\",\"comments\":[");
+                for (std::size_t i = 0; i < comments.size(); ++i) {
+                    if (i != 0) out.put(',');
+                    ::write_bracket(out, "bracket_comment", comments[i].value, input);
+                }
+                out.put(']');
+            }
+
+            if (element.comment) {
+                out.write(",\"comment\":");
+                ::write_line_comment(out, *element.comment, input);
+            }
+            out.write("}\n");
+        }
+    }
+}
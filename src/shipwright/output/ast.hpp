@@ -0,0 +1,27 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <string_view>
+
+#include <shipwright/ast/ast.hpp>
+#include <shipwright/output/writer.hpp>
+
+namespace shipwright::output {
+    // Writes each element of `file` as one line of JSON. A command invocation is written as
+    //     {"type":"command_invocation","offset":0,"command":"project","arguments":[...]}
+    // and a line with no command, which may hold bracket comments, as
+    //     {"type":"comments","comments":[...]}
+    // Either ends with a "comment" member if the line ends in a line comment.
+    //
+    // Arguments and comments are written as {"type":"quoted_argument","offset":9,"text":"..."},
+    // plus "bracket_strength" for bracket arguments and comments. Parenthesized arguments
+    // are written as {"type":"parenthesized_argument","arguments":[...]}.
+    //
+    // Offsets are in bytes from the start of `input`, which `file` must have been parsed from.
+    void write_ast_json_lines(buffered_writer& out, ast::file const& file, std::string_view input);
+}
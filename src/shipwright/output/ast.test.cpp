@@ -0,0 +1,43 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "./ast.hpp"
+
+#include <shipwright/parser/parser.hpp>
+
+#include <catch2/catch.hpp>
+#include <shipwright/test/capture.test.hpp>
+
+#include <string>
+#include <string_view>
+
+namespace output = shipwright::output;
+
+TEST_CASE("ASTs are written as JSON lines", "[output]")
+{
+    std::string const input = "project(x \"y\" [[z]] (a) # c\n)\n"
+                              "#[[b]] # d\n";
+
+    auto const file = shipwright::parse(input);
+    REQUIRE(file);
+
+    auto const result = shipwright::test::capture(
+        [&](output::buffered_writer& out) { output::write_ast_json_lines(out, *file, input); });
+
+    CHECK(result
+        == R"({"type":"command_invocation","offset":0,"command":"project","arguments":[)"
+           R"({"type":"unquoted_argument","offset":8,"text":"x"},)"
+           R"({"type":"quoted_argument","offset":11,"text":"y"},)"
+           R"({"type":"bracket_argument","offset":16,"text":"z","bracket_strength":0},)"
+           R"({"type":"parenthesized_argument","arguments":[)"
+           R"({"type":"unquoted_argument","offset":21,"text":"a"}]},)"
+           R"({"type":"line_comment","offset":25,"text":" c"}]})"
+           "\n"
+           R"({"type":"comments","comments":[)"
+           R"({"type":"bracket_comment","offset":33,"text":"b","bracket_strength":0}],)"
+           R"("comment":{"type":"line_comment","offset":38,"text":" d"}})"
+           "\n");
+}
@@ -0,0 +1,134 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "./tokens.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <functional>
+
+#include <shipwright/input/utf8.hpp>
+
+namespace {
+    using shipwright::output::buffered_writer;
+    using shipwright::output::offset_of;
+
+    // `value` must be valid UTF-8
+    void write_json_characters(buffered_writer& out, std::string_view value)
+    {
+        constexpr char hex[] = "0123456789abcdef";
+
+        // Copy runs of characters which need no escaping in one go
+        std::size_t run_start = 0;
+        for (std::size_t i = 0; i < value.size(); ++i) {
+            auto const c = static_cast<unsigned char>(value[i]);
+            if (c >= 0x20 && c != '"' && c != '\\') continue;
+
+            out.write(value.substr(run_start, i - run_start));
+            run_start = i + 1;
+
+            switch (c) {
+            case '"': out.write("\\\""); break;
+            case '\\': out.write("\\\\"); break;
+            case '\n': out.write("\\n"); break;
+            case '\r': out.write("\\r"); break;
+            case '\t': out.write("\\t"); break;
+            default:
+                out.write("\\u00");
+                out.put(hex[c >> 4]);
+                out.put(hex[c & 0xF]);
+            }
+        }
+        out.write(value.substr(run_start));
+    }
+
+    void write_text(buffered_writer& out, shipwright::token const& token)
+    {
+        out.put('<');
+        out.write(shipwright::token_type_name(token.type));
+        out.write(": \"");
+        out.write(token.text);
+        out.write("\">\n");
+    }
+
+    void write_json(buffered_writer& out, shipwright::token const& token, std::string_view input)
+    {
+        out.write("{\"type\":\"");
+        out.write(shipwright::token_type_name(token.type));
+        out.write("\",\"offset\":");
+        out.write_decimal(offset_of(token.text, input));
+        out.write(",\"length\":");
+        out.write_decimal(token.text.size());
+        out.write(",\"full_offset\":");
+        out.write_decimal(offset_of(token.full_text, input));
+        out.write(",\"full_length\":");
+        out.write_decimal(token.full_text.size());
+        out.write(",\"text\":");
+        shipwright::output::write_json_string(out, token.text);
+        out.write("}\n");
+    }
+
+    void write_binary(buffered_writer& out, shipwright::token const& token, std::string_view input)
+    {
+        out.put(static_cast<char>(token.type));
+        out.write_u32_le(offset_of(token.text, input));
+        out.write_u32_le(static_cast<std::uint32_t>(token.text.size()));
+        out.write_u32_le(offset_of(token.full_text, input));
+        out.write_u32_le(static_cast<std::uint32_t>(token.full_text.size()));
+    }
+}
+
+namespace shipwright::output {
+    std::optional<format> parse_format(std::string_view name)
+    {
+        if (name == "text") return format::text;
+        if (name == "jsonl") return format::json_lines;
+        if (name == "binary") return format::binary;
+        return std::nullopt;
+    }
+
+    void write_header(buffered_writer& out, format fmt)
+    {
+        if (fmt == format::binary) {
+            out.write("SWTK");
+            out.put('\x01');
+        }
+    }
+
+    void write_token(buffered_writer& out, format fmt, token const& token, std::string_view input)
+    {
+        switch (fmt) {
+        case format::text: return ::write_text(out, token);
+        case format::json_lines: return ::write_json(out, token, input);
+        case format::binary: return ::write_binary(out, token, input);
+        }
+    }
+
+    std::uint32_t offset_of(std::string_view part, std::string_view input)
+    {
+        assert(std::less_equal<>{}(input.data(), part.data()));
+        assert(input.size() <= max_input_bytes);
+
+        return static_cast<std::uint32_t>(part.data() - input.data());
+    }
+
+    void write_json_string(buffered_writer& out, std::string_view value)
+    {
+        out.put('"');
+
+        // JSON text must be valid Unicode, so each byte of any invalid UTF-8 is replaced
+        for (;;) {
+            auto const invalid = input::find_invalid_utf8(value);
+            ::write_json_characters(out, value.substr(0, invalid.value_or(value.size())));
+            if (!invalid) break;
+
+            out.write("\\ufffd");
+            value.remove_prefix(*invalid + 1);
+        }
+
+        out.put('"');
+    }
+}
@@ -0,0 +1,56 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string_view>
+
+#include <shipwright/output/writer.hpp>
+#include <shipwright/token.hpp>
+
+namespace shipwright::output {
+    // The largest input any format can describe, as offsets and lengths are written as u32.
+    // Callers must reject larger inputs before writing anything about them.
+    constexpr std::size_t max_input_bytes = std::numeric_limits<std::uint32_t>::max();
+
+    enum class format
+    {
+        // `<type: "text">`, as `debug_print` produces
+        text,
+        // One JSON object per line:
+        // {"type":"quoted_argument","offset":4,"length":5,"full_offset":3,"full_length":7,"text":"..."}
+        json_lines,
+        // A 5-byte header, "SWTK" followed by a version byte (1), then one fixed-size record
+        // per token. Each record is 17 bytes:
+        //     u8  the `token_type` value
+        //     u32 offset of `text`
+        //     u32 length of `text`
+        //     u32 offset of `full_text`
+        //     u32 length of `full_text`
+        // All integers are little-endian, and offsets are in bytes from the start of the input.
+        binary,
+    };
+
+    // Accepts "text", "jsonl" and "binary".
+    std::optional<format> parse_format(std::string_view name);
+
+    // Writes whatever must precede the first token.
+    void write_header(buffered_writer& out, format fmt);
+
+    // `token` must refer into `input`, which must be at most `max_input_bytes` long.
+    void write_token(buffered_writer& out, format fmt, token const& token, std::string_view input);
+
+    // The offset of `part`, which must refer into `input`, as every format writes it.
+    std::uint32_t offset_of(std::string_view part, std::string_view input);
+
+    // Writes `value` as a quoted JSON string. Each byte of any invalid UTF-8 is written as
+    // U+FFFD, the replacement character, so the output is always valid JSON.
+    void write_json_string(buffered_writer& out, std::string_view value);
+}
@@ -0,0 +1,99 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "./tokens.hpp"
+
+#include <catch2/catch.hpp>
+#include <shipwright/test/capture.test.hpp>
+
+#include <string>
+#include <string_view>
+
+namespace output = shipwright::output;
+using shipwright::test::capture;
+using shipwright::token;
+using shipwright::token_type;
+
+TEST_CASE("Writes are buffered and flushed in order", "[output]")
+{
+    auto const result = capture([](output::buffered_writer& out) {
+        out.write("short ");
+        out.write("a string longer than the whole buffer ");
+        out.put('x');
+        out.write_decimal(0);
+        out.put(' ');
+        out.write_decimal(18446744073709551615u);
+    });
+
+    CHECK(result == "short a string longer than the whole buffer x0 18446744073709551615");
+}
+
+TEST_CASE("JSON strings are escaped", "[output]")
+{
+    auto const result = capture([](output::buffered_writer& out) {
+        output::write_json_string(out, "a\"b\\c\nd\te\x01");
+    });
+
+    CHECK(result == R"("a\"b\\c\nd\te\u0001")");
+}
+
+TEST_CASE("JSON strings replace invalid UTF-8", "[output]")
+{
+    auto const json = [](std::string_view value) {
+        return capture([&](output::buffered_writer& out) { output::write_json_string(out, value); });
+    };
+
+    // Valid UTF-8 is written as it is
+    CHECK(json("caf\xC3\xA9 \xE2\x82\xAC") == "\"caf\xC3\xA9 \xE2\x82\xAC\"");
+
+    CHECK(json("a\xFF" "b") == R"("a\ufffdb")");
+    CHECK(json("\x80\x80") == R"("\ufffd\ufffd")");
+    // A truncated sequence, at the end and before other text
+    CHECK(json("a\xE2\x82") == R"("a\ufffd\ufffd")");
+    CHECK(json("\xE2\x82\"x\xC3\xA9") == "\"\\ufffd\\ufffd\\\"x\xC3\xA9\"");
+}
+
+TEST_CASE("Tokens can be written in each format", "[output]")
+{
+    std::string_view const input = "x(\"y\")";
+    token const quoted{input.substr(3, 1), token_type::quoted_argument, input.substr(2, 3)};
+
+    SECTION("text")
+    {
+        CHECK(capture([&](output::buffered_writer& out) {
+            output::write_token(out, output::format::text, quoted, input);
+        }) == "<quoted_argument: \"y\">\n");
+    }
+
+    SECTION("jsonl")
+    {
+        CHECK(capture([&](output::buffered_writer& out) {
+            output::write_token(out, output::format::json_lines, quoted, input);
+        }) == R"({"type":"quoted_argument","offset":3,"length":1,"full_offset":2,"full_length":3,"text":"y"})"
+               "\n");
+    }
+
+    SECTION("binary")
+    {
+        auto const result = capture([&](output::buffered_writer& out) {
+            output::write_header(out, output::format::binary);
+            output::write_token(out, output::format::binary, quoted, input);
+        });
+
+        CHECK(result
+            == std::string{"SWTK\x01", 5}
+                + std::string{static_cast<char>(token_type::quoted_argument)}
+                + std::string{"\x03\0\0\0\x01\0\0\0\x02\0\0\0\x03\0\0\0", 16});
+    }
+}
+
+TEST_CASE("Format names are parsed", "[output]")
+{
+    CHECK(output::parse_format("text") == output::format::text);
+    CHECK(output::parse_format("jsonl") == output::format::json_lines);
+    CHECK(output::parse_format("binary") == output::format::binary);
+    CHECK_FALSE(output::parse_format("json"));
+}
@@ -0,0 +1,46 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "./writer.hpp"
+
+#include <charconv>
+
+namespace shipwright::output {
+    void buffered_writer::write_decimal(std::uint64_t value)
+    {
+        char digits[20];
+        auto const result = std::to_chars(digits, digits + sizeof(digits), value);
+        write(std::string_view{digits, static_cast<std::size_t>(result.ptr - digits)});
+    }
+
+    bool buffered_writer::flush()
+    {
+        drain();
+
+        if (std::fflush(out_) != 0) failed_ = true;
+        return !failed_;
+    }
+
+    void buffered_writer::drain()
+    {
+        if (size_ != 0 && std::fwrite(buffer_.data(), 1, size_, out_) != size_) failed_ = true;
+        size_ = 0;
+    }
+
+    void buffered_writer::write_slow(std::string_view data)
+    {
+        drain();
+
+        // Too big to be worth copying; hand it straight over
+        if (data.size() >= buffer_.size()) {
+            if (std::fwrite(data.data(), 1, data.size(), out_) != data.size()) failed_ = true;
+            return;
+        }
+
+        std::memcpy(buffer_.data(), data.data(), data.size());
+        size_ = data.size();
+    }
+}
@@ -0,0 +1,77 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+namespace shipwright::output {
+    // Accumulates output in a large buffer and hands it to a `std::FILE` in big blocks,
+    // avoiding the per-insertion overhead of iostreams.
+    class buffered_writer
+    {
+    public:
+        explicit buffered_writer(std::FILE* out, std::size_t capacity = 64 * 1024)
+            : out_{out}
+            , buffer_(capacity)
+        {}
+
+        buffered_writer(buffered_writer const&) = delete;
+        buffered_writer& operator=(buffered_writer const&) = delete;
+
+        ~buffered_writer()
+        {
+            flush();
+        }
+
+        void put(char c)
+        {
+            if (size_ == buffer_.size()) drain();
+            buffer_[size_++] = c;
+        }
+
+        void write(std::string_view data)
+        {
+            if (data.size() > buffer_.size() - size_) {
+                write_slow(data);
+                return;
+            }
+            std::memcpy(buffer_.data() + size_, data.data(), data.size());
+            size_ += data.size();
+        }
+
+        void write_decimal(std::uint64_t value);
+
+        void write_u32_le(std::uint32_t value)
+        {
+            char const bytes[] = {
+                static_cast<char>(value & 0xFF),
+                static_cast<char>((value >> 8) & 0xFF),
+                static_cast<char>((value >> 16) & 0xFF),
+                static_cast<char>((value >> 24) & 0xFF),
+            };
+            write(std::string_view{bytes, sizeof(bytes)});
+        }
+
+        // Returns false if any write to the underlying file has failed.
+        bool flush();
+
+    private:
+        // Hands the buffer to the file without flushing the file itself
+        void drain();
+        void write_slow(std::string_view data);
+
+        std::FILE* out_;
+        std::vector<char> buffer_;
+        std::size_t size_ = 0;
+        bool failed_ = false;
+    };
+}
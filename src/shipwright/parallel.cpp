@@ -0,0 +1,59 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "./parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace shipwright {
+    void parallel_for(
+        std::size_t count, unsigned threads, std::function<void(std::size_t)> const& body)
+    {
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        threads = static_cast<unsigned>(std::min<std::size_t>(threads, count));
+
+        if (threads <= 1) {
+            for (std::size_t i = 0; i < count; ++i) {
+                body(i);
+            }
+            return;
+        }
+
+        std::atomic<std::size_t> next{0};
+        std::mutex error_mutex;
+        std::exception_ptr error;
+
+        auto const work = [&] {
+            for (auto i = next++; i < count; i = next++) {
+                try {
+                    body(i);
+                } catch (...) {
+                    std::lock_guard lock{error_mutex};
+                    if (!error) error = std::current_exception();
+                    next = count;
+                }
+            }
+        };
+
+        std::vector<std::thread> workers;
+        workers.reserve(threads - 1);
+        for (unsigned i = 1; i < threads; ++i) {
+            workers.emplace_back(work);
+        }
+        work();
+
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        if (error) std::rethrow_exception(error);
+    }
+}
@@ -0,0 +1,19 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace shipwright {
+    // Calls `body(i)` for each `i` in [0, count), spread over up to `threads` threads.
+    // A `threads` of 0 means one per hardware thread. The calling thread takes part.
+    // If any call throws, the remaining indices are abandoned and one of the exceptions is
+    // rethrown once all threads have finished.
+    void parallel_for(
+        std::size_t count, unsigned threads, std::function<void(std::size_t)> const& body);
+}
@@ -0,0 +1,35 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <optional>
+#include <string_view>
+#include <variant>
+
+#include <shipwright/ast/ast.hpp>
+#include <shipwright/error.hpp>
+#include <shipwright/limits.hpp>
+#include <shipwright/token.hpp>
+
+namespace shipwright {
+    struct parse_options
+    {
+        shipwright::limits limits = {};
+        // With `trivia::skip`, the AST has no comments, and no elements for blank lines.
+        // Parsing is faster, since the lexer never hands the trivia to the parser.
+        shipwright::trivia trivia = shipwright::trivia::keep;
+    };
+
+    // Parses a full CMake file.
+    // The resulting AST refers into `input`, which must outlive it.
+    // Parsing stops at the first error, including as soon as any limit is exceeded.
+    std::variant<ast::file, parse_error> parse(
+        std::string_view input, parse_options const& options);
+
+    // Returns `std::nullopt` if `input` could not be parsed.
+    std::optional<ast::file> parse(std::string_view input);
+}
@@ -0,0 +1,171 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "./parser.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <string>
+#include <variant>
+
+using shipwright::error_kind;
+using shipwright::parse;
+using shipwright::parse_error;
+using shipwright::parse_options;
+namespace ast = shipwright::ast;
+
+TEST_CASE("Can parse command invocations", "[parser]")
+{
+    std::string const input = "project(shipwright VERSION 0.0.1)\n"
+                              "\n"
+                              "add_subdirectory(src) # comment\n";
+
+    auto const result = parse(input);
+    REQUIRE(result);
+    REQUIRE(result->elements.size() == 3);
+
+    auto const* project = std::get_if<ast::command_invocation>(&result->elements[0].value);
+    REQUIRE(project);
+    CHECK(project->command_id.value == "project");
+    REQUIRE(project->arguments.size() == 3);
+    auto const* first = std::get_if<ast::unquoted_argument>(&project->arguments[0].value);
+    REQUIRE(first);
+    CHECK(first->value == "shipwright");
+
+    CHECK(std::holds_alternative<std::vector<ast::bracket_comment>>(result->elements[1].value));
+
+    auto const* subdirectory = std::get_if<ast::command_invocation>(&result->elements[2].value);
+    REQUIRE(subdirectory);
+    CHECK(subdirectory->command_id.value == "add_subdirectory");
+    REQUIRE(result->elements[2].comment);
+    CHECK(result->elements[2].comment->value == " comment");
+}
+
+TEST_CASE("Spaces may trail a command invocation", "[parser]")
+{
+    auto const result = parse(std::string{"project(x)  \t\n"});
+    REQUIRE(result);
+    CHECK(result->elements.size() == 1);
+}
+
+TEST_CASE("The last line needn't end in a newline", "[parser]")
+{
+    auto const result = parse(std::string{"project(x)"});
+    REQUIRE(result);
+    CHECK(result->elements.size() == 1);
+}
+
+TEST_CASE("Parse failures produce no AST", "[parser]")
+{
+    auto const input = GENERATE(as<std::string>{}, "project(\n", "project)\n", "(project)\n");
+
+    CAPTURE(input);
+
+    CHECK_FALSE(parse(input));
+}
+
+TEST_CASE("Syntax errors are reported where they occur", "[parser]")
+{
+    std::string const input = "project(x)\nfoo)\n";
+
+    auto const result = parse(input, parse_options{});
+    auto const* error = std::get_if<parse_error>(&result);
+    REQUIRE(error);
+    CHECK(error->kind == error_kind::syntax_error);
+    CHECK(error->offset == 14);
+}
+
+TEST_CASE("Limits abort parsing", "[parser]")
+{
+    std::string const input = "a(((b)))\n"
+                              "c(d e f g)\n";
+
+    auto const error_of = [&](shipwright::limits const& limits) {
+        auto const result = parse(input, parse_options{limits});
+        auto const* error = std::get_if<parse_error>(&result);
+        REQUIRE(error);
+        return *error;
+    };
+
+    shipwright::limits limits;
+
+    SECTION("No limits")
+    {
+        CHECK(std::holds_alternative<ast::file>(parse(input, parse_options{limits})));
+    }
+
+    SECTION("Bytes")
+    {
+        limits.max_bytes = input.size() - 1;
+        CHECK(error_of(limits).kind == error_kind::too_many_bytes);
+    }
+
+    SECTION("Tokens")
+    {
+        limits.max_tokens = 10;
+        auto const error = error_of(limits);
+        CHECK(error.kind == error_kind::too_many_tokens);
+        CHECK(error.offset == 10);
+    }
+
+    SECTION("Token size")
+    {
+        limits.max_token_bytes = 0;
+        CHECK(error_of(limits).kind == error_kind::token_too_long);
+    }
+
+    SECTION("Nesting depth")
+    {
+        limits.max_nesting_depth = 1;
+        auto const error = error_of(limits);
+        CHECK(error.kind == error_kind::too_deeply_nested);
+        CHECK(error.offset == 2);
+    }
+
+    SECTION("AST nodes")
+    {
+        limits.max_ast_nodes = 5;
+        CHECK(error_of(limits).kind == error_kind::too_many_ast_nodes);
+    }
+
+    SECTION("AST bytes")
+    {
+        limits.max_ast_bytes = sizeof(ast::argument);
+        CHECK(error_of(limits).kind == error_kind::too_many_ast_bytes);
+    }
+}
+
+TEST_CASE("Skipping trivia leaves comments out of the AST", "[parser]")
+{
+    std::string const input = "# leading\n"
+                              "\n"
+                              "set(A # comment\n"
+                              "    b #[[bracket]] c) # trailing\n"
+                              "#[[file-level]]\n";
+
+    parse_options options;
+    options.trivia = shipwright::trivia::skip;
+
+    auto const result = parse(input, options);
+    auto const* file = std::get_if<ast::file>(&result);
+    REQUIRE(file);
+    REQUIRE(file->elements.size() == 1);
+
+    auto const& element = file->elements[0];
+    CHECK_FALSE(element.comment);
+
+    auto const* set = std::get_if<ast::command_invocation>(&element.value);
+    REQUIRE(set);
+    CHECK(set->command_id.value == "set");
+    REQUIRE(set->arguments.size() == 3);
+    for (auto const& argument : set->arguments) {
+        CHECK(std::holds_alternative<ast::unquoted_argument>(argument.value));
+    }
+
+    auto const full = parse(input);
+    REQUIRE(full);
+    CHECK(full->elements.size() == 4);
+}
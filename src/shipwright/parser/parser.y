@@ -10,21 +10,57 @@
 %define api.namespace {shipwright::_parser}
 %define api.value.type variant
 %define api.value.automove
+%define parse.error verbose
 
 %code requires {
+#include <cstddef>
+#include <optional>
+#include <string_view>
+
 #include <shipwright/ast/ast.hpp>
+#include <shipwright/error.hpp>
 #include <shipwright/lexer.hpp>
+#include <shipwright/limits.hpp>
+
+namespace shipwright::_parser {
+    // State shared by the token source, the grammar actions and `shipwright::parse`
+    struct context
+    {
+        std::string_view input;
+        shipwright::lexer const& lex;
+        shipwright::limits const& limits;
+        // Otherwise, elements which hold nothing but comments are left out of `result`
+        bool keep_trivia = true;
+
+        shipwright::ast::file result = {};
+        std::optional<shipwright::parse_error> error = {};
+
+        // Offset of the most recently read token
+        std::size_t offset = 0;
+        bool at_line_start = true;
+        std::size_t depth = 0;
+        std::size_t ast_nodes = 0;
+        std::size_t ast_bytes = 0;
+
+        // Each returns false, having set `error`, if doing so exceeds a limit
+        bool enter_parentheses();
+        bool add_node(std::size_t size);
+    };
+}
 }
 
-%parse-param {lexer::iterator first} {lexer::iterator last}
-%lex-param {lexer::iterator& first} {lexer::iterator last}
+%parse-param {lexer::iterator first} {lexer::iterator last} {shipwright::_parser::context& ctx}
+%lex-param {lexer::iterator& first} {lexer::iterator last} {shipwright::_parser::context& ctx}
 
 %code {
 #include <algorithm>
+#include <cassert>
 #include <iostream>
 #include <iterator>
 #include <string_view>
+#include <utility>
 
+#include <shipwright/parser/parser.hpp>
 #include <shipwright/token.hpp>
 
 using shipwright::token_type;
@@ -37,12 +73,30 @@ namespace {
 }
 
 namespace shipwright::_parser {
-    int yylex(parser::semantic_type* token_value, lexer::iterator& first, lexer::iterator last) {
-        if (first == last) return 0; // EOF
+    int yylex(parser::semantic_type* token_value, lexer::iterator& first, lexer::iterator last,
+              context& ctx) {
+        if (first == last) {
+            ctx.offset = ctx.input.size();
+            // If the lexer gave up early, make sure parsing fails rather than accept a prefix
+            if (ctx.lex.error()) return parser::token::ERROR;
+
+            // The last line needn't end in a newline, but the grammar needs one
+            if (!ctx.at_line_start) {
+                ctx.at_line_start = true;
+                return parser::token::NEWLINE;
+            }
+            return 0; // EOF
+        }
 
-        auto token = *first++;
+        // Not `*first++`: the iterator's postfix increment returns the advanced iterator
+        auto token = *first;
+        ++first;
+        ctx.offset = static_cast<std::size_t>(token.full_text.data() - ctx.input.data());
+        ctx.at_line_start = token.type == token_type::newline;
 
-        if (token.type == token_type::bracket_argument || token.type == token_type::bracket_comment) {
+        switch (token.type) {
+        case token_type::bracket_argument:
+        case token_type::bracket_comment: {
             auto first_bracket = std::find(token.full_text.begin(), token.full_text.end(), '[');
             auto next_bracket = std::find(std::next(first_bracket), token.full_text.end(), '[');
 
@@ -50,24 +104,30 @@ namespace shipwright::_parser {
                 token.text,
                 std::distance(first_bracket, next_bracket) - 1,
             });
-        } else {
+            break;
+        }
+        case token_type::space:
+        case token_type::identifier:
+        case token_type::quoted_argument:
+        case token_type::unquoted_argument:
+        case token_type::line_comment:
             token_value->emplace<std::string_view>(token.text);
+            break;
+        default:
+            // The token has no semantic value; giving it one would confuse the parser
+            break;
         }
 
         return as_bison(token.type);
     }
-
-    void yyerror(char const* msg) {
-        std::cerr << msg << '\n';
-    }
 }
 }
 
 %token <std::string_view>                   SPACE
 %token                                      NEWLINE
 %token <std::string_view>                   IDENTIFIER
-%token                                      LPAREN  '('
-%token                                      RPAREN  ')'
+%token                                      LPAREN
+%token                                      RPAREN
 
 %token <shipwright::ast::bracket_argument>  BRACKET_ARGUMENT
 
@@ -83,18 +143,28 @@ namespace shipwright::_parser {
 %token                                      UNTERMINATED_QUOTE
 %token                                      ERROR
 
-%start file
+%start root
 %%
 
+root:
+    file                                        { ctx.result = $1; }
+;
+
 %type <shipwright::ast::file> file;
 file:
-    file file_element                           { $$ = $1; $$.elements.push_back($2); }
+    file file_element                           { $$ = $1;
+                                                  // Bound once: with automove, each `$2` is a move
+                                                  auto element = $2;
+                                                  if (ctx.keep_trivia || std::holds_alternative<shipwright::ast::command_invocation>(element.value)) {
+                                                      if (!ctx.add_node(sizeof(shipwright::ast::file_element))) YYABORT;
+                                                      $$.elements.push_back(std::move(element));
+                                                  } }
     | %empty                                    { $$ = shipwright::ast::file{}; }
 ;
 
 %type <shipwright::ast::file_element> file_element;
 file_element:
-    command_invocation line_ending              { $$ = shipwright::ast::file_element{$1, $2}; }
+    command_invocation allow_spaces line_ending { $$ = shipwright::ast::file_element{$1, $3}; }
     | space_or_comment_element line_ending      { $$ = shipwright::ast::file_element{$1, $2}; }
 ;
 
@@ -106,7 +176,9 @@ command_invocation:
 
 %type <std::vector<shipwright::ast::bracket_comment>> space_or_comment_element;
 space_or_comment_element:
-    space_or_comment_element bracket_comment    { $$ = $1; $$.push_back($2); }
+    space_or_comment_element bracket_comment allow_spaces
+                                                { if (!ctx.add_node(sizeof(shipwright::ast::bracket_comment))) YYABORT;
+                                                  $$ = $1; $$.push_back($2); }
     | allow_spaces                              { $$ = {}; }
 ;
 
@@ -137,14 +209,17 @@ separation:
 
 %type <std::vector<shipwright::ast::argument>> arguments;
 arguments:
-    arguments argument[arg]                     { $$ = $1; $$.push_back($arg); }
+    arguments argument[arg]                     { if (!ctx.add_node(sizeof(shipwright::ast::argument))) YYABORT;
+                                                  $$ = $1; $$.push_back($arg); }
     | arguments separation                      { $$ = $1; }
     | %empty                                    { $$ = {}; }
 ;
 
 %type <shipwright::ast::parenthesized_argument> parenthesized_argument;
 parenthesized_argument:
-    '(' arguments[args] ')'                     { $$ = shipwright::ast::parenthesized_argument{$args}; }
+    LPAREN                                      { if (!ctx.enter_parentheses()) YYABORT; }
+    arguments[args] RPAREN                      { --ctx.depth;
+                                                  $$ = shipwright::ast::parenthesized_argument{$args}; }
 ;
 
 %type <shipwright::ast::bracket_argument> bracket_argument;
@@ -160,6 +235,8 @@ quoted_argument:
 %type <shipwright::ast::unquoted_argument> unquoted_argument;
 unquoted_argument:
     UNQUOTED_ARGUMENT                           { $$ = shipwright::ast::unquoted_argument{$1}; }
+    // Bare words such as `VERSION` lex as identifiers
+    | IDENTIFIER                                { $$ = shipwright::ast::unquoted_argument{$1}; }
 ;
 
 %type <shipwright::ast::line_comment> line_comment;
@@ -212,3 +289,56 @@ namespace {
         }
     }
 }
+
+namespace shipwright::_parser {
+    bool context::enter_parentheses() {
+        if (++depth <= limits.max_nesting_depth) return true;
+
+        error = parse_error{error_kind::too_deeply_nested, offset, "parentheses nested too deeply"};
+        return false;
+    }
+
+    bool context::add_node(std::size_t size) {
+        ast_bytes += size;
+        if (++ast_nodes > limits.max_ast_nodes) {
+            error = parse_error{error_kind::too_many_ast_nodes, offset, "too many AST nodes"};
+            return false;
+        }
+        if (ast_bytes > limits.max_ast_bytes) {
+            error = parse_error{error_kind::too_many_ast_bytes, offset, "AST is too large"};
+            return false;
+        }
+        return true;
+    }
+
+    void parser::error(std::string const& msg) {
+        if (!ctx.error) ctx.error = parse_error{error_kind::syntax_error, ctx.offset, msg};
+    }
+}
+
+namespace shipwright {
+    std::variant<ast::file, parse_error> parse(std::string_view input, parse_options const& options)
+    {
+        lexer lex{input, options.limits, options.trivia};
+        yy::context ctx{input, lex, options.limits, options.trivia == trivia::keep};
+
+        yy::parser impl{lex.begin(), lex.end(), ctx};
+        if (impl.parse() != 0) {
+            // The grammar only sees that the tokens stopped; report why
+            if (lex.error()) return *lex.error();
+
+            assert(ctx.error);
+            return *std::move(ctx.error);
+        }
+
+        return std::move(ctx.result);
+    }
+
+    std::optional<ast::file> parse(std::string_view input)
+    {
+        auto result = shipwright::parse(input, parse_options{});
+        if (auto* file = std::get_if<ast::file>(&result)) return std::move(*file);
+
+        return std::nullopt;
+    }
+}
@@ -0,0 +1,136 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "./index.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <variant>
+
+#include <shipwright/input/input.hpp>
+#include <shipwright/parser/parser.hpp>
+
+namespace {
+    bool ends_with(std::string_view str, std::string_view suffix)
+    {
+        return str.size() >= suffix.size()
+            && str.substr(str.size() - suffix.size()) == suffix;
+    }
+}
+
+namespace shipwright {
+    bool is_cmake_file(std::string_view path)
+    {
+        auto const filename = path.substr(path.find_last_of('/') + 1);
+
+        return filename == "CMakeLists.txt" || ends_with(filename, ".cmake");
+    }
+
+    source_location locate(std::string_view text, std::string_view span)
+    {
+        assert(std::less_equal<>{}(text.data(), span.data()));
+        assert(std::less_equal<>{}(span.data(), text.data() + text.size()));
+
+        auto const before = text.substr(0, static_cast<std::size_t>(span.data() - text.data()));
+        auto const line_start = before.find_last_of('\n');
+
+        return source_location{
+            static_cast<std::size_t>(std::count(before.begin(), before.end(), '\n')) + 1,
+            before.size() - (line_start == std::string_view::npos ? 0 : line_start + 1) + 1,
+        };
+    }
+
+    bool project_index::update(std::string const& path)
+    {
+        input::load_options load_options;
+        load_options.max_bytes = options_.limits.max_bytes;
+
+        auto loaded = input::load_file(path, load_options);
+        if (!loaded) {
+            remove(path);
+            return false;
+        }
+
+        auto new_entry = std::make_unique<entry>();
+        if (loaded->too_large) {
+            new_entry->error = parse_error{error_kind::too_many_bytes, 0, "file is too large"};
+        } else {
+            new_entry->text = std::move(loaded->text);
+            new_entry->invalid_utf8_offset = loaded->invalid_utf8_offset;
+            parse_into(*new_entry);
+        }
+        insert(path, std::move(new_entry));
+        return true;
+    }
+
+    void project_index::update(std::string const& path, std::string text)
+    {
+        auto new_entry = std::make_unique<entry>();
+        new_entry->text = std::move(text);
+        new_entry->invalid_utf8_offset = input::find_invalid_utf8(new_entry->text);
+        parse_into(*new_entry);
+        insert(path, std::move(new_entry));
+    }
+
+    void project_index::parse_into(entry& new_entry) const
+    {
+        auto result = shipwright::parse(new_entry.text, options_);
+
+        if (auto* file = std::get_if<ast::file>(&result)) {
+            new_entry.file = std::move(*file);
+        } else {
+            new_entry.error = std::move(std::get<parse_error>(result));
+        }
+    }
+
+    void project_index::index_variables(std::string const& path, entry const& new_entry)
+    {
+        if (new_entry.file) {
+            variables_.update(path, new_entry.text, *new_entry.file);
+        } else {
+            variables_.remove(path);
+        }
+    }
+
+    void project_index::insert(std::string const& path, std::unique_ptr<entry> new_entry)
+    {
+        auto& line_starts = new_entry->line_starts;
+        line_starts.push_back(0);
+        for (std::size_t i = 0; i < new_entry->text.size(); ++i) {
+            if (new_entry->text[i] == '\n') line_starts.push_back(i + 1);
+        }
+        index_variables(path, *new_entry);
+
+        entries_.insert_or_assign(path, std::move(new_entry));
+    }
+
+    source_location project_index::entry::locate(std::size_t offset) const
+    {
+        assert(offset <= text.size());
+        assert(!line_starts.empty());
+
+        // The last line starting at or before `offset`
+        auto const next_line = std::upper_bound(line_starts.begin(), line_starts.end(), offset);
+        auto const line = static_cast<std::size_t>(next_line - line_starts.begin());
+
+        return source_location{line, offset - line_starts[line - 1] + 1};
+    }
+
+    bool project_index::remove(std::string const& path)
+    {
+        variables_.remove(path);
+        return entries_.erase(path) != 0;
+    }
+
+    project_index::entry const* project_index::find(std::string const& path) const
+    {
+        auto const it = entries_.find(path);
+        if (it == entries_.end()) return nullptr;
+
+        return it->second.get();
+    }
+}
@@ -0,0 +1,119 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <shipwright/ast/ast.hpp>
+#include <shipwright/error.hpp>
+#include <shipwright/parser/parser.hpp>
+#include <shipwright/project/variables.hpp>
+
+namespace shipwright {
+    // Whether `path` names a file which CMake would read as a script:
+    // a `CMakeLists.txt` or a `*.cmake` file.
+    bool is_cmake_file(std::string_view path);
+
+    struct source_location
+    {
+        // Both 1-based.
+        std::size_t line;
+        std::size_t column;
+    };
+
+    // Finds the line and column of `span`, which must refer into `text`.
+    source_location locate(std::string_view text, std::string_view span);
+
+    // Keeps the parsed contents of a set of files in memory so that they can be
+    // queried repeatedly without re-reading or re-lexing anything.
+    class project_index
+    {
+    public:
+        struct entry
+        {
+            // Less any byte order mark. Empty if the file was too large to read.
+            std::string text;
+            // Refers into `text`. Empty if `text` could not be parsed.
+            std::optional<ast::file> file;
+            // Why `text` could not be parsed, if it couldn't
+            std::optional<parse_error> error;
+            // Offset into `text` of the first invalid UTF-8 sequence, if any
+            std::optional<std::size_t> invalid_utf8_offset;
+            // Offset into `text` at which each line starts, the first always being 0
+            std::vector<std::size_t> line_starts;
+
+            // As `shipwright::locate`, for the position `offset` bytes into `text`,
+            // but without rescanning `text`.
+            source_location locate(std::size_t offset) const;
+        };
+
+        project_index() = default;
+
+        // Every file is parsed with `options`, so its limits bound the cost of any one file.
+        explicit project_index(parse_options options)
+            : options_{std::move(options)}
+        {}
+
+        // Reads, validates and parses the file at `path`, replacing any previous entry.
+        // Returns false if the file could not be read, in which case the entry is removed.
+        // A file larger than the limits allow is rejected without reading all of it.
+        bool update(std::string const& path);
+
+        // Parses `text` as the contents of `path`, replacing any previous entry.
+        void update(std::string const& path, std::string text);
+
+        // Returns false if there was no entry for `path`.
+        bool remove(std::string const& path);
+
+        // Removes every entry.
+        void clear()
+        {
+            entries_.clear();
+            variables_.clear();
+        }
+
+        // Where each variable is defined and read, across every file which parsed
+        variable_index const& variables() const
+        {
+            return variables_;
+        }
+
+        entry const* find(std::string const& path) const;
+
+        std::size_t size() const
+        {
+            return entries_.size();
+        }
+
+        // Calls `fn(path, entry)` for each indexed file, in no particular order.
+        template <typename Fn>
+        void for_each(Fn&& fn) const
+        {
+            for (auto const& [path, entry] : entries_) {
+                fn(std::string_view{path}, *entry);
+            }
+        }
+
+    private:
+        void parse_into(entry& new_entry) const;
+        void index_variables(std::string const& path, entry const& new_entry);
+        void insert(std::string const& path, std::unique_ptr<entry> new_entry);
+
+        parse_options options_;
+        // Entries are boxed so that the ASTs' views into `entry::text` stay valid
+        // regardless of what happens to the map.
+        std::unordered_map<std::string, std::unique_ptr<entry const>> entries_;
+        variable_index variables_;
+    };
+}
@@ -0,0 +1,207 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "./index.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <set>
+#include <string>
+#include <system_error>
+#include <string_view>
+#include <vector>
+
+using shipwright::is_cmake_file;
+using shipwright::locate;
+using shipwright::project_index;
+
+namespace {
+    // A new, empty directory under the system's temporary directory, removed along with
+    // everything in it when this goes out of scope
+    class temporary_directory
+    {
+    public:
+        temporary_directory()
+        {
+            auto const base = std::filesystem::temp_directory_path();
+            std::random_device random;
+            do {
+                path_ = base / ("shipwright.index.test." + std::to_string(random()));
+            } while (!std::filesystem::create_directory(path_));
+        }
+
+        temporary_directory(temporary_directory const&) = delete;
+        temporary_directory& operator=(temporary_directory const&) = delete;
+
+        ~temporary_directory()
+        {
+            std::error_code ignored;
+            std::filesystem::remove_all(path_, ignored);
+        }
+
+        std::string file(std::string const& name) const
+        {
+            return (path_ / name).string();
+        }
+
+    private:
+        std::filesystem::path path_;
+    };
+}
+
+TEST_CASE("Recognizes CMake files", "[project]")
+{
+    CHECK(is_cmake_file("CMakeLists.txt"));
+    CHECK(is_cmake_file("src/CMakeLists.txt"));
+    CHECK(is_cmake_file("cmake/glob_mixed.cmake"));
+    CHECK(is_cmake_file(".cmake"));
+
+    CHECK_FALSE(is_cmake_file("CMakeLists.txt.in"));
+    CHECK_FALSE(is_cmake_file("cmakelists.txt"));
+    CHECK_FALSE(is_cmake_file("src/lexer.cpp"));
+    CHECK_FALSE(is_cmake_file("CMakeLists.txt/readme"));
+    CHECK_FALSE(is_cmake_file(""));
+}
+
+TEST_CASE("Locates spans by line and column", "[project]")
+{
+    std::string_view const text = "ab\ncd\n\nef";
+
+    auto const check = [&](std::size_t offset, std::size_t line, std::size_t column) {
+        CAPTURE(offset);
+        auto const location = locate(text, text.substr(offset, 1));
+        CHECK(location.line == line);
+        CHECK(location.column == column);
+    };
+
+    check(0, 1, 1);
+    check(1, 1, 2);
+    check(2, 1, 3);
+    check(3, 2, 1);
+    check(4, 2, 2);
+    check(6, 3, 1);
+    check(7, 4, 1);
+    check(8, 4, 2);
+}
+
+TEST_CASE("Index entries locate offsets without rescanning", "[project]")
+{
+    std::string_view const text = "ab\ncd\n\nef";
+
+    project_index index;
+    index.update("CMakeLists.txt", std::string{text});
+
+    auto const* entry = index.find("CMakeLists.txt");
+    REQUIRE(entry);
+    CHECK(entry->line_starts == std::vector<std::size_t>{0, 3, 6, 7});
+
+    for (std::size_t offset = 0; offset <= text.size(); ++offset) {
+        CAPTURE(offset);
+        auto const expected = locate(text, text.substr(offset, 0));
+        auto const location = entry->locate(offset);
+        CHECK(location.line == expected.line);
+        CHECK(location.column == expected.column);
+    }
+}
+
+TEST_CASE("Project index holds parsed files", "[project]")
+{
+    project_index index;
+    CHECK(index.size() == 0);
+    CHECK(index.find("CMakeLists.txt") == nullptr);
+
+    index.update("CMakeLists.txt", "project(x)\nadd_subdirectory(src)\n");
+    index.update("src/CMakeLists.txt", "add_library(a)\n");
+    index.update("bad.cmake", "project(\n");
+
+    CHECK(index.size() == 3);
+
+    auto const* root = index.find("CMakeLists.txt");
+    REQUIRE(root);
+    REQUIRE(root->file);
+    CHECK(root->file->elements.size() == 2);
+
+    auto const* bad = index.find("bad.cmake");
+    REQUIRE(bad);
+    CHECK(bad->text == "project(\n");
+    CHECK_FALSE(bad->file);
+
+    std::set<std::string> paths;
+    index.for_each([&](std::string_view path, auto const&) { paths.emplace(path); });
+    CHECK(paths == std::set<std::string>{"CMakeLists.txt", "src/CMakeLists.txt", "bad.cmake"});
+
+    SECTION("Updating replaces an entry")
+    {
+        index.update("bad.cmake", "project(fixed)\n");
+
+        CHECK(index.size() == 3);
+        auto const* fixed = index.find("bad.cmake");
+        REQUIRE(fixed);
+        CHECK(fixed->file);
+    }
+
+    SECTION("Entries can be removed")
+    {
+        CHECK(index.remove("bad.cmake"));
+        CHECK_FALSE(index.remove("bad.cmake"));
+
+        CHECK(index.size() == 2);
+        CHECK(index.find("bad.cmake") == nullptr);
+    }
+}
+
+TEST_CASE("Project index reads files from disk", "[project]")
+{
+    temporary_directory const directory;
+    std::string const path = directory.file("CMakeLists.txt");
+    {
+        std::ofstream file{path, std::ios::binary};
+        file << "set(A 1)\n";
+    }
+
+    project_index index;
+    CHECK(index.update(path));
+
+    auto const* entry = index.find(path);
+    REQUIRE(entry);
+    CHECK(entry->text == "set(A 1)\n");
+    CHECK(entry->file);
+
+    std::remove(path.c_str());
+
+    // The file is gone, so its entry goes too
+    CHECK_FALSE(index.update(path));
+    CHECK(index.find(path) == nullptr);
+}
+
+TEST_CASE("Project index rejects files over the size limit", "[project]")
+{
+    temporary_directory const directory;
+    std::string const path = directory.file("CMakeLists.txt");
+    {
+        std::ofstream file{path, std::ios::binary};
+        file << "set(A 1)\nset(B 2)\n";
+    }
+
+    shipwright::limits limits;
+    limits.max_bytes = 10;
+    project_index index{shipwright::parse_options{limits}};
+    CHECK(index.update(path));
+
+    std::remove(path.c_str());
+
+    auto const* entry = index.find(path);
+    REQUIRE(entry);
+    CHECK(entry->text.empty());
+    CHECK_FALSE(entry->file);
+    REQUIRE(entry->error);
+    CHECK(entry->error->kind == shipwright::error_kind::too_many_bytes);
+    CHECK(index.variables().find("A").empty());
+}
@@ -0,0 +1,323 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "./variables.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include <shipwright/strings.hpp>
+
+namespace {
+    using shipwright::iequals;
+    using shipwright::variable_use;
+    namespace ast = shipwright::ast;
+
+    bool is_letter(char c)
+    {
+        return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+    }
+
+    // Not computed from other variables, and not an `ENV{...}` or `CACHE{...}` variable
+    bool is_literal_name(std::string_view name)
+    {
+        return !name.empty() && name.find_first_of("${}\\") == std::string_view::npos;
+    }
+
+    // The text of each argument, as CMake would number them. Comments are not arguments.
+    // Parenthesized arguments have no single text, so they're empty.
+    std::vector<std::string_view> positional_arguments(std::vector<ast::argument> const& arguments)
+    {
+        std::vector<std::string_view> result;
+        result.reserve(arguments.size());
+
+        for (auto const& argument : arguments) {
+            std::visit(
+                [&](auto const& value) {
+                    using type = std::decay_t<decltype(value)>;
+
+                    if constexpr (std::is_same_v<type, ast::bracket_argument>
+                        || std::is_same_v<type, ast::quoted_argument>
+                        || std::is_same_v<type, ast::unquoted_argument>) {
+                        result.push_back(value.value);
+                    } else if constexpr (std::is_same_v<type, ast::parenthesized_argument>) {
+                        result.emplace_back();
+                    }
+                },
+                argument.value);
+        }
+
+        return result;
+    }
+
+    // `list(<subcommand> <list> ...)` subcommands which modify <list> in place
+    bool list_modifies(std::string_view subcommand)
+    {
+        constexpr std::string_view subcommands[] = {
+            "APPEND",
+            "FILTER",
+            "INSERT",
+            "POP_BACK",
+            "POP_FRONT",
+            "PREPEND",
+            "REMOVE_AT",
+            "REMOVE_DUPLICATES",
+            "REMOVE_ITEM",
+            "REVERSE",
+            "SORT",
+        };
+        return std::find(std::begin(subcommands), std::end(subcommands), subcommand)
+            != std::end(subcommands);
+    }
+
+    // `list(<subcommand> <list> ... <out-var>)` subcommands which only read <list>
+    bool list_reads(std::string_view subcommand)
+    {
+        return subcommand == "LENGTH" || subcommand == "GET" || subcommand == "JOIN"
+            || subcommand == "SUBLIST" || subcommand == "FIND";
+    }
+
+    bool may_name_variables(std::string_view command)
+    {
+        return iequals(command, "set") || iequals(command, "unset")
+            || iequals(command, "option") || iequals(command, "math")
+            || iequals(command, "list");
+    }
+
+    // Works out which positional arguments of `command` name variables, and how they're
+    // used. Appends `{position, use}` pairs to `names`, in order of position.
+    void find_named_variables(std::string_view command, std::vector<std::string_view> const& args,
+        std::vector<std::pair<std::size_t, variable_use>>& names)
+    {
+        if (args.empty()) return;
+
+        if (iequals(command, "set")) {
+            names.emplace_back(0, variable_use::set);
+        } else if (iequals(command, "unset")) {
+            names.emplace_back(0, variable_use::unset);
+        } else if (iequals(command, "option")) {
+            names.emplace_back(0, variable_use::option);
+        } else if (iequals(command, "math")) {
+            if (args.size() >= 2 && args[0] == "EXPR") names.emplace_back(1, variable_use::math);
+        } else if (iequals(command, "list") && args.size() >= 2) {
+            auto const subcommand = args[0];
+
+            if (subcommand == "POP_BACK" || subcommand == "POP_FRONT") {
+                // Each of the trailing arguments receives a popped element
+                for (std::size_t i = 1; i < args.size(); ++i) {
+                    names.emplace_back(i, variable_use::list);
+                }
+            } else if (::list_modifies(subcommand)) {
+                names.emplace_back(1, variable_use::list);
+            } else if (::list_reads(subcommand)) {
+                names.emplace_back(1, variable_use::reference);
+                if (args.size() >= 3) names.emplace_back(args.size() - 1, variable_use::list);
+            } else if (subcommand == "TRANSFORM") {
+                auto const output = std::find(args.begin() + 2, args.end(), "OUTPUT_VARIABLE");
+                if (output != args.end() && output + 1 != args.end()) {
+                    names.emplace_back(1, variable_use::reference);
+                    names.emplace_back(
+                        static_cast<std::size_t>(output + 1 - args.begin()), variable_use::list);
+                } else {
+                    names.emplace_back(1, variable_use::list);
+                }
+            }
+        }
+    }
+
+    void for_each_reference_in(ast::argument const& argument,
+        std::function<void(std::string_view, variable_use)> const& fn)
+    {
+        std::visit(
+            [&](auto const& value) {
+                using type = std::decay_t<decltype(value)>;
+
+                // Neither bracket arguments nor comments are expanded
+                if constexpr (std::is_same_v<type, ast::quoted_argument>
+                    || std::is_same_v<type, ast::unquoted_argument>) {
+                    shipwright::for_each_variable_reference(value.value,
+                        [&](std::string_view name) { fn(name, variable_use::reference); });
+                } else if constexpr (std::is_same_v<type, ast::parenthesized_argument>) {
+                    for (auto const& nested : value.values) {
+                        ::for_each_reference_in(nested, fn);
+                    }
+                }
+            },
+            argument.value);
+    }
+}
+
+namespace shipwright {
+    std::string_view variable_use_name(variable_use use)
+    {
+        switch (use) {
+        case variable_use::set:
+            return "set";
+        case variable_use::unset:
+            return "unset";
+        case variable_use::option:
+            return "option";
+        case variable_use::list:
+            return "list";
+        case variable_use::math:
+            return "math";
+        case variable_use::reference:
+            return "reference";
+        }
+        return "unknown";
+    }
+
+    void for_each_variable_reference(
+        std::string_view text, std::function<void(std::string_view)> const& fn)
+    {
+        // Most arguments reference nothing
+        if (text.find('$') == std::string_view::npos) return;
+
+        struct open_reference
+        {
+            std::size_t name_start;
+            // False for `$ENV{` and `$CACHE{`
+            bool is_variable;
+        };
+        std::vector<open_reference> open;
+
+        for (std::size_t i = 0; i < text.size(); ++i) {
+            switch (text[i]) {
+            case '\\':
+                // Escape sequences such as `\$` never start or end a reference
+                ++i;
+                break;
+            case '$': {
+                auto brace = i + 1;
+                while (brace < text.size() && ::is_letter(text[brace])) {
+                    ++brace;
+                }
+                if (brace < text.size() && text[brace] == '{') {
+                    open.push_back(open_reference{brace + 1, brace == i + 1});
+                    i = brace;
+                }
+                break;
+            }
+            case '}':
+                if (!open.empty()) {
+                    auto const reference = open.back();
+                    open.pop_back();
+
+                    auto const name = text.substr(reference.name_start, i - reference.name_start);
+                    if (reference.is_variable && ::is_literal_name(name)) fn(name);
+                }
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    void for_each_variable_use(
+        ast::file const& file, std::function<void(std::string_view, variable_use)> const& fn)
+    {
+        std::vector<std::string_view> args;
+        std::vector<std::pair<std::size_t, variable_use>> names;
+
+        for (auto const& element : file.elements) {
+            auto const* command = std::get_if<ast::command_invocation>(&element.value);
+            if (!command) continue;
+
+            names.clear();
+            args.clear();
+            if (::may_name_variables(command->command_id.value)) {
+                args = ::positional_arguments(command->arguments);
+                ::find_named_variables(command->command_id.value, args, names);
+            }
+
+            // Report names and references in the order they appear
+            auto next_name = names.begin();
+            std::size_t position = 0;
+
+            for (auto const& argument : command->arguments) {
+                if (ast::is_comment(argument)) continue;
+
+                if (next_name != names.end() && next_name->first == position) {
+                    if (::is_literal_name(args[position])) fn(args[position], next_name->second);
+                    ++next_name;
+                }
+
+                ::for_each_reference_in(argument, fn);
+                ++position;
+            }
+        }
+    }
+
+    void variable_index::update(
+        std::string const& path, std::string_view text, ast::file const& file)
+    {
+        remove(path);
+
+        auto const [file_it, inserted] = files_.try_emplace(path);
+        (void)inserted;
+        // Keys of an `unordered_map` never move, so sites may refer to this one
+        std::string_view const key = file_it->first;
+        auto& entry = file_it->second;
+
+        shipwright::for_each_variable_use(file, [&](std::string_view name, variable_use use) {
+            auto& sites = sites_[std::string{name}];
+
+            // This file's sites are all added together, so only the last can be from it
+            if (sites.empty() || sites.back().path.data() != key.data()) {
+                entry.names.emplace_back(name);
+            }
+            sites.push_back(site{
+                key,
+                static_cast<std::size_t>(name.data() - text.data()),
+                use,
+            });
+        });
+    }
+
+    bool variable_index::remove(std::string const& path)
+    {
+        auto const it = files_.find(path);
+        if (it == files_.end()) return false;
+
+        remove_sites(it->first, it->second);
+        files_.erase(it);
+        return true;
+    }
+
+    void variable_index::clear()
+    {
+        files_.clear();
+        sites_.clear();
+    }
+
+    std::vector<variable_index::site> const& variable_index::find(std::string const& name) const
+    {
+        static std::vector<site> const none;
+
+        auto const it = sites_.find(name);
+        return it == sites_.end() ? none : it->second;
+    }
+
+    void variable_index::remove_sites(std::string_view path, file_entry const& entry)
+    {
+        auto const from_path = [&](site const& site) { return site.path.data() == path.data(); };
+
+        for (auto const& name : entry.names) {
+            auto const it = sites_.find(name);
+            if (it == sites_.end()) continue;
+
+            auto& sites = it->second;
+            // Each file's sites are contiguous
+            auto const first = std::find_if(sites.begin(), sites.end(), from_path);
+            sites.erase(first, std::find_if_not(first, sites.end(), from_path));
+
+            if (sites.empty()) sites_.erase(it);
+        }
+    }
+}
@@ -0,0 +1,93 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <shipwright/ast/ast.hpp>
+
+namespace shipwright {
+    enum class variable_use
+    {
+        // Definitions: the variable is the one named by `set(<name> ...)`, etc.
+        set,
+        unset,
+        option,
+        // Any `list()` subcommand which writes to <name>
+        list,
+        math,
+
+        // The variable is read, either through `${name}` or by a command which takes the
+        // name of a variable to read, such as `list(LENGTH <name> ...)`.
+        reference,
+    };
+
+    inline bool is_definition(variable_use use)
+    {
+        return use != variable_use::reference;
+    }
+
+    // The enumerator's name, e.g. "option"
+    std::string_view variable_use_name(variable_use use);
+
+    // Calls `fn(name)` for each `${name}` in `text`, including those nested inside other
+    // references. `name` refers into `text`. References whose names are themselves
+    // computed, such as the outer one of `${a_${b}}`, are skipped, as are `$ENV{...}`
+    // and `$CACHE{...}`.
+    void for_each_variable_reference(
+        std::string_view text, std::function<void(std::string_view)> const& fn);
+
+    // Calls `fn(name, use)` for each variable which `file` defines or reads.
+    // `name` refers into the text `file` was parsed from.
+    void for_each_variable_use(
+        ast::file const& file, std::function<void(std::string_view, variable_use)> const& fn);
+
+    // Maps variable names to everywhere they are defined and read across a set of files.
+    // Only names known before running CMake are indexed: `set(${prefix}_FLAGS ...)`
+    // defines nothing as far as this index is concerned.
+    class variable_index
+    {
+    public:
+        struct site
+        {
+            // Refers into the index, so is invalidated when the file is updated or removed
+            std::string_view path;
+            // Offset of the variable name into the file's text
+            std::size_t offset;
+            variable_use use;
+        };
+
+        // Indexes `file`, which was parsed from `text`, replacing any previous sites for `path`.
+        void update(std::string const& path, std::string_view text, ast::file const& file);
+
+        // Returns false if `path` had not been indexed.
+        bool remove(std::string const& path);
+
+        void clear();
+
+        // Every site of `name`, grouped by file, in order within each file.
+        // Variable names are case-sensitive.
+        std::vector<site> const& find(std::string const& name) const;
+
+    private:
+        struct file_entry
+        {
+            // The names with a site in this file, each once
+            std::vector<std::string> names;
+        };
+
+        void remove_sites(std::string_view path, file_entry const& entry);
+
+        std::unordered_map<std::string, file_entry> files_;
+        std::unordered_map<std::string, std::vector<site>> sites_;
+    };
+}
@@ -0,0 +1,136 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "./variables.hpp"
+
+#include <shipwright/parser/parser.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+using shipwright::variable_index;
+using shipwright::variable_use;
+
+namespace {
+    std::vector<std::string> references_in(std::string_view text)
+    {
+        std::vector<std::string> result;
+        shipwright::for_each_variable_reference(
+            text, [&](std::string_view name) { result.emplace_back(name); });
+        return result;
+    }
+
+    std::vector<std::pair<std::string, variable_use>> uses_in(std::string const& text)
+    {
+        auto const file = shipwright::parse(text);
+        REQUIRE(file);
+
+        std::vector<std::pair<std::string, variable_use>> result;
+        shipwright::for_each_variable_use(*file,
+            [&](std::string_view name, variable_use use) { result.emplace_back(name, use); });
+        return result;
+    }
+}
+
+TEST_CASE("Finds variable references in argument text", "[variables]")
+{
+    using list = std::vector<std::string>;
+
+    CHECK(::references_in("no references") == list{});
+    CHECK(::references_in("${A}") == list{"A"});
+    CHECK(::references_in("-I${A}/include;${B}") == list{"A", "B"});
+    CHECK(::references_in("${A_${B}}") == list{"B"});
+    CHECK(::references_in("$ENV{PATH} $CACHE{X} ${Y}") == list{"Y"});
+    CHECK(::references_in("\\${A} ${B}") == list{"B"});
+    CHECK(::references_in("$<TARGET_FILE:${T}>") == list{"T"});
+    CHECK(::references_in("${unterminated") == list{});
+}
+
+TEST_CASE("Finds variable definitions and uses in a file", "[variables]")
+{
+    using list = std::vector<std::pair<std::string, variable_use>>;
+
+    CHECK(::uses_in("set(A 1)\n") == list{{"A", variable_use::set}});
+    CHECK(::uses_in("SET(A ${B})\n")
+        == list{{"A", variable_use::set}, {"B", variable_use::reference}});
+    CHECK(::uses_in("set(\"A\" 1)\n") == list{{"A", variable_use::set}});
+    CHECK(::uses_in("set(${P}_A 1)\n") == list{{"P", variable_use::reference}});
+    CHECK(::uses_in("set(ENV{A} 1)\n") == list{});
+    CHECK(::uses_in("unset(A)\n") == list{{"A", variable_use::unset}});
+    CHECK(::uses_in("option(A \"doc\" OFF)\n") == list{{"A", variable_use::option}});
+    CHECK(::uses_in("math(EXPR A \"${B} + 1\")\n")
+        == list{{"A", variable_use::math}, {"B", variable_use::reference}});
+    CHECK(::uses_in("list(APPEND A x y)\n") == list{{"A", variable_use::list}});
+    CHECK(::uses_in("list(LENGTH A N)\n")
+        == list{{"A", variable_use::reference}, {"N", variable_use::list}});
+    CHECK(::uses_in("list(POP_BACK A X Y)\n")
+        == list{{"A", variable_use::list}, {"X", variable_use::list}, {"Y", variable_use::list}});
+    CHECK(::uses_in("list(TRANSFORM A TOUPPER OUTPUT_VARIABLE B)\n")
+        == list{{"A", variable_use::reference}, {"B", variable_use::list}});
+    CHECK(::uses_in("list(TRANSFORM A TOUPPER)\n") == list{{"A", variable_use::list}});
+    CHECK(::uses_in("message(${A} [[${B}]] # ${C}\n)\n") == list{{"A", variable_use::reference}});
+    CHECK(::uses_in("if((${A}))\n") == list{{"A", variable_use::reference}});
+    CHECK(::uses_in("set( # comment\n    A 1)\n") == list{{"A", variable_use::set}});
+}
+
+TEST_CASE("Variable index maps names to sites", "[variables]")
+{
+    std::string const a = "set(FLAGS -O2)\nmessage(${FLAGS})\n";
+    std::string const b = "list(APPEND FLAGS -g)\n";
+
+    auto const a_file = shipwright::parse(a);
+    auto const b_file = shipwright::parse(b);
+    REQUIRE(a_file);
+    REQUIRE(b_file);
+
+    variable_index index;
+    index.update("a.cmake", a, *a_file);
+    index.update("b.cmake", b, *b_file);
+
+    auto const& sites = index.find("FLAGS");
+    REQUIRE(sites.size() == 3);
+
+    auto const site_in = [&](std::string_view path) {
+        std::vector<std::pair<std::size_t, variable_use>> result;
+        for (auto const& site : index.find("FLAGS")) {
+            if (site.path == path) result.emplace_back(site.offset, site.use);
+        }
+        return result;
+    };
+
+    using list = std::vector<std::pair<std::size_t, variable_use>>;
+    CHECK(site_in("a.cmake") == list{{4, variable_use::set}, {25, variable_use::reference}});
+    CHECK(site_in("b.cmake") == list{{12, variable_use::list}});
+
+    CHECK(index.find("flags").empty());
+
+    SECTION("Updating a file replaces its sites")
+    {
+        std::string const c = "set(OTHER 1)\n";
+        auto const c_file = shipwright::parse(c);
+        REQUIRE(c_file);
+
+        index.update("a.cmake", c, *c_file);
+
+        CHECK(site_in("a.cmake").empty());
+        CHECK(site_in("b.cmake") == list{{12, variable_use::list}});
+        CHECK(index.find("OTHER").size() == 1);
+    }
+
+    SECTION("Removing a file removes its sites")
+    {
+        CHECK(index.remove("b.cmake"));
+        CHECK_FALSE(index.remove("b.cmake"));
+
+        CHECK(index.find("FLAGS").size() == 2);
+
+        CHECK(index.remove("a.cmake"));
+        CHECK(index.find("FLAGS").empty());
+    }
+}
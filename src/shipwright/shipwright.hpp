@@ -7,4 +7,5 @@
 #pragma once
 
 #include <shipwright/lexer.hpp>
+#include <shipwright/parser.hpp>
 #include <shipwright/token.hpp>
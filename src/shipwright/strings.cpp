@@ -0,0 +1,40 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "./strings.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace {
+    unsigned char to_lower(char c)
+    {
+        return static_cast<unsigned char>(c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c);
+    }
+}
+
+namespace shipwright {
+    bool iequals(std::string_view lhs, std::string_view rhs)
+    {
+        if (lhs.size() != rhs.size()) return false;
+
+        for (std::size_t i = 0; i < lhs.size(); ++i) {
+            if (::to_lower(lhs[i]) != ::to_lower(rhs[i])) return false;
+        }
+        return true;
+    }
+
+    bool iless(std::string_view lhs, std::string_view rhs)
+    {
+        auto const size = std::min(lhs.size(), rhs.size());
+        for (std::size_t i = 0; i < size; ++i) {
+            auto const l = ::to_lower(lhs[i]);
+            auto const r = ::to_lower(rhs[i]);
+            if (l != r) return l < r;
+        }
+        return lhs.size() < rhs.size();
+    }
+}
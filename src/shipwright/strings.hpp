@@ -0,0 +1,17 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <string_view>
+
+namespace shipwright {
+    // Compares ignoring the case of ASCII letters, as CMake compares command names.
+    bool iequals(std::string_view lhs, std::string_view rhs);
+
+    // Orders as if both were lowercase, consistently with `iequals`.
+    bool iless(std::string_view lhs, std::string_view rhs);
+}
@@ -0,0 +1,39 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstdio>
+#include <string>
+
+#include <catch2/catch.hpp>
+
+#include <shipwright/output/writer.hpp>
+
+namespace shipwright::test {
+    // Runs `fn` with a writer, returning everything it wrote. The writer's buffer is tiny,
+    // so that anything longer than a few bytes is also written across several flushes.
+    template <typename Fn>
+    std::string capture(Fn&& fn)
+    {
+        auto* file = std::tmpfile();
+        REQUIRE(file);
+
+        {
+            output::buffered_writer out{file, 16};
+            fn(out);
+        }
+
+        std::string result;
+        std::rewind(file);
+        for (int c; (c = std::fgetc(file)) != EOF;) {
+            result += static_cast<char>(c);
+        }
+        std::fclose(file);
+
+        return result;
+    }
+}
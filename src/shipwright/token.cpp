@@ -34,12 +34,17 @@ namespace {
 }
 
 namespace shipwright {
-    std::ostream& operator<<(std::ostream& lhs, debug_print<token_type> const& rhs)
+    std::string_view token_type_name(token_type type)
     {
-        auto const lookup = type_stringify.find(rhs.value);
+        auto const lookup = type_stringify.find(type);
         assert(lookup != type_stringify.end());
 
-        return lhs << lookup->second;
+        return lookup->second;
+    }
+
+    std::ostream& operator<<(std::ostream& lhs, debug_print<token_type> const& rhs)
+    {
+        return lhs << token_type_name(rhs.value);
     }
 
     std::ostream& operator<<(std::ostream& lhs, debug_print<token> const& rhs)
@@ -34,6 +34,17 @@ namespace shipwright {
         end_of_file,
     };
 
+    // The enumerator's name, e.g. "quoted_argument"
+    std::string_view token_type_name(token_type type);
+
+    // Whether to produce tokens which don't change what a file means: spaces, comments,
+    // and newlines within parentheses, where they only separate arguments.
+    enum class trivia
+    {
+        keep,
+        skip,
+    };
+
     std::ostream& operator<<(std::ostream& lhs, debug_print<token_type> const& rhs);
 
     struct token
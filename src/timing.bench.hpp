@@ -0,0 +1,39 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+namespace shipwright::bench {
+    // How many times each measurement is repeated. Only the fastest run is reported, being
+    // the least disturbed by anything else running.
+    constexpr int repetitions = 10;
+
+    // The number of lines of input to generate: the first argument, if given
+    inline int input_lines(int argc, char** argv)
+    {
+        return argc > 1 ? std::atoi(argv[1]) : 20000;
+    }
+
+    // The fastest of `repetitions` calls to `fn`, in milliseconds
+    template <typename Fn>
+    double best_of_ms(Fn&& fn)
+    {
+        using clock = std::chrono::steady_clock;
+
+        double best = 1e300;
+        for (int i = 0; i < repetitions; ++i) {
+            auto const start = clock::now();
+            fn();
+            std::chrono::duration<double, std::milli> const elapsed = clock::now() - start;
+            best = std::min(best, elapsed.count());
+        }
+        return best;
+    }
+}